@@ -183,6 +183,17 @@ class CPUAllocator : public IAllocator {
   void Free(void* p) override;
 };
 
+// CPU allocator whose memory is placed on a NUMA node when it is first touched.
+class NumaCPUAllocator : public CPUAllocator {
+ public:
+  explicit NumaCPUAllocator(int numa_node) : numa_node_(numa_node) {}
+
+  void* Alloc(size_t size) override;
+
+ private:
+  const int numa_node_;
+};
+
 using AllocatorPtr = std::shared_ptr<IAllocator>;
 
 void* AllocatorDefaultAlloc(size_t size);
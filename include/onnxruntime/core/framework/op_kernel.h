@@ -116,6 +116,22 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed weights that were persisted to a file by an earlier session
+  // (see kOrtSessionOptionsConfigPrepackedWeightsCacheFile). PrePack() is not called for the input if the
+  // buffers are used, so the kernel must be able to restore any metadata it sets in PrePack() from the tensor.
+  // It is also called with the buffers PrePack() just filled in, which are only written to the file if it uses them.
+  // @param tensor: The initialized constant tensor the buffers were packed from
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffers: The buffers filled in by PrePack(), in the same order. The buffers are not owned
+  //                           by the kernel and are read-only.
+  // @param used_persisted_buffers: Set to true if the kernel uses the buffers. If false, PrePack() is called.
+  virtual Status UsePersistedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                              std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                              /*out*/ bool& used_persisted_buffers) {
+    used_persisted_buffers = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
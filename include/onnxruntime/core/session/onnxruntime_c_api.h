@@ -293,6 +293,17 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+/** \brief Callback function for OrtApi::RunAsync
+*
+* \param[in] user_data The user_data passed to OrtApi::RunAsync
+* \param[in] outputs The `outputs` array passed to OrtApi::RunAsync. On success every entry holds an ::OrtValue,
+*   and the ones that were nullptr when the run was queued must be freed with OrtApi::ReleaseValue.
+* \param[in] num_outputs Number of elements in `outputs`
+* \param[in] status nullptr if the run succeeded, otherwise an ::OrtStatus that must be freed with OrtApi::ReleaseStatus
+*/
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(_In_opt_ void* user_data, _Inout_updates_all_(num_outputs) OrtValue** outputs,
+                                               size_t num_outputs, _In_opt_ OrtStatusPtr status);
+
 /** \brief Graph optimization level
 *
 * Refer to https://www.onnxruntime.ai/docs/resources/graph-optimizations.html
@@ -3421,6 +3432,42 @@ struct OrtApi {
   * \since Version 1.12.
   */
   ORT_CLASS_RELEASE(Op);
+
+  /** \brief Run the model in an ::OrtSession without blocking the calling thread
+  *
+  * Queues the run on the session's inter-op thread pool (or on the intra-op thread pool if the session does not have
+  * one, which is the case for ::ORT_SEQUENTIAL execution) and returns immediately. `run_async_callback` is invoked
+  * from a thread pool thread once the run completes.
+  *
+  * The input names, input values and output names are copied before this function returns, as is `run_options`,
+  * so OrtApi::RunOptionsSetTerminate has no effect on a run that has already been queued.
+  * The `outputs` array must remain valid until the callback is invoked. The session must not be released until
+  * all callbacks for runs queued on it have been invoked.
+  *
+  * This function fails if the thread pool used has no worker threads, as the run would execute synchronously.
+  *
+  * \param[in] session
+  * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+  * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+  * \param[in] input Array of ::OrtValue%s of the input values
+  * \param[in] input_len Number of elements in the input_names and inputs arrays
+  * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+  * \param[in] output_names_len Number of elements in the output_names and outputs array
+  * \param[out] output Array of ::OrtValue%s that the outputs are stored in. Entries that are nullptr are allocated
+  *     by the run and set before the callback is invoked. The array is passed back to `run_async_callback`.
+  * \param[in] run_async_callback Callback invoked with the outputs and status once the run completes
+  * \param[in] user_data Passed through to `run_async_callback`
+  *
+  * \snippet{doc} snippets.dox OrtStatus Return Value
+  *
+  * \since Version 1.12.
+  */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
 };
 
 /*
@@ -428,6 +428,24 @@ struct Session : Base<OrtSession> {
 
   void Run(const RunOptions& run_options, const struct IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Queue a run of the model and return without waiting for it to complete
+  *
+  * Wraps OrtApi::RunAsync
+  *
+  * \param[in] run_options
+  * \param[in] input_names Array of null terminated strings of length input_count that is the list of input names
+  * \param[in] input_values Array of Value objects of length input_count that is the list of input values
+  * \param[in] input_count Number of inputs (the size of the input_names & input_values arrays)
+  * \param[in] output_names Array of C style strings of length output_count that is the list of output names
+  * \param[out] output_values Array of Value objects of length output_count. Must remain valid until `callback` is
+  *   invoked. Empty entries are filled in with the outputs of the run before `callback` is invoked.
+  * \param[in] output_count Number of outputs (the size of the output_names & output_values arrays)
+  * \param[in] callback Invoked on a thread pool thread with the outputs and status once the run completes
+  * \param[in] user_data Passed through to `callback`
+  */
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data);
+
   size_t GetInputCount() const;                   ///< Returns the number of model inputs
   size_t GetOutputCount() const;                  ///< Returns the number of model outputs
   size_t GetOverridableInitializerCount() const;  ///< Returns the number of inputs that have defaults that can be overridden
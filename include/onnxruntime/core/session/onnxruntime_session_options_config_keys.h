@@ -20,6 +20,15 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Path of a file to persist the pre-packed weights of CPU kernels to, e.g. the model path with a ".prepacked" suffix.
+// If the file exists it is memory mapped and the kernels that support it use the pre-packed weights from it in place
+// instead of calling PrePack(). Otherwise, or if some weights are not in it, the file is (re)written after the
+// session is initialized.
+// Entries are keyed by the kernel, the weight contents and the CPU features, so a file that doesn't match the
+// model or machine only results in weights being pre-packed again.
+// Weights shared between sessions with a PrepackedWeightsContainer don't use the file.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsCacheFile = "session.prepacked_weights_cache_file";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -119,3 +128,30 @@ static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dyn
 // "0": in some cases warnings will be logged but processing will continue. The default.
 // May be useful to expose bugs in models.
 static const char* const kOrtSessionOptionsConfigStrictShapeTypeInference = "session.strict_shape_type_inference";
+
+// Enables dynamic batching of concurrent Run calls when set to a value greater than "1".
+// Concurrent requests with matching feeds and outputs are concatenated along dim 0 into a single run of up to this
+// many rows, and the outputs are split back along dim 0. All model inputs and outputs must have a symbolic dim 0,
+// and only requests with CPU tensor feeds and no pre-allocated outputs are batched.
+// The default is "0" (disabled).
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching.max_batch_size";
+
+// Maximum time in microseconds that the first request of a dynamic batch waits for other requests to join.
+// Only used if dynamic batching is enabled. The default is "1000".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxWaitUs = "session.dynamic_batching.max_wait_us";
+
+// Representative graph input shapes used to pre-reserve the memory arenas during session initialization.
+// For each shape set, the peak activation memory per device is computed from the execution plan, and each arena is
+// extended by a single region of the largest peak, so the first requests don't pay for growing the arena.
+// Shape sets are separated by "|", the inputs of a set by ";" and the dims of an input by ",", and all graph inputs
+// must be listed in each set. For example, "input_ids:1,128;attention_mask:1,128|input_ids:8,128;attention_mask:8,128".
+// The default is "" (no reservation).
+static const char* const kOrtSessionOptionsConfigArenaReserveInputShapes = "session.memory.arena_reserve_input_shapes";
+
+// Binds the session to a NUMA node, given as the node index, e.g. "0".
+// The per-session intra-op and inter-op thread pools run on the processors of the node. When the thread pool size
+// is not set, they get one thread per processor of the node. The default CPU execution provider places its memory
+// on the node. This includes the initializers and prepacked weights, so creating one session per node gives each
+// node a local copy of the weights. Sessions bound to different nodes should not share a prepacked weights container.
+// The default is "-1" (not bound).
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
@@ -55,7 +55,8 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     float,
     kCpuExecutionProvider,
     KernelDefBuilder()
-        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .MayInplace(4, 1),
     Attention<float>);
 
 Status AttentionBase::CheckInputs(const TensorShape& input_shape,
@@ -63,7 +64,8 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const TensorShape& bias_shape,
                                   const Tensor*& mask_index,
                                   const Tensor* past,
-                                  const Tensor* extra_add_qk) const {
+                                  const Tensor* extra_add_qk,
+                                  const Tensor* past_seq_len) const {
   // Input shapes:
   //   input       : (batch_size, sequence_length, input_hidden_size)
   //   weights     : (input_hidden_size, 3 * hidden_size)
@@ -73,7 +75,9 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
   //                 or (batch_size, past_sequence_length + sequence_length)
   //                 or (batch_size, sequence_length, past_sequence_length + sequence_length)
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //                 or (2, batch_size, num_heads, max_sequence_length, head_size) when past_present_share_buffer is set
   //   extra_add_qk: (batch_size, num_heads, sequence_length, sequence_length)
+  //   past_seq_len: (1) when past_present_share_buffer is set
   //
   // Where hidden_size = num_heads * head_size.
   // When a model is pruned (like some attention heads are removed), hidden_size < input_hidden_size.
@@ -173,6 +177,22 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Inputs 'past' dimension 2 shall have length of ", hidden_size / num_heads_);
     }
     past_sequence_length = static_cast<int>(past_dims[3]);
+
+    if (past_present_share_buffer_) {
+      if (past_seq_len == nullptr || past_seq_len->Shape().Size() != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_sequence_length' with one element is required when past_present_share_buffer is set");
+      }
+
+      // past dimension 3 is the capacity of the buffer, which has to fit the past and current tokens
+      const int max_sequence_length = past_sequence_length;
+      past_sequence_length = *past_seq_len->template Data<int32_t>();
+      if (past_sequence_length < 0 || past_sequence_length + sequence_length > max_sequence_length) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'past_sequence_length' is ", past_sequence_length,
+                               ". It shall not be negative, and the sum with sequence_length shall not exceed dimension 3 of 'past' (",
+                               max_sequence_length, ")");
+      }
+    }
   }
 
   if (mask_index != nullptr) {  // mask_index is optional
@@ -244,6 +264,10 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                   const Tensor* past,
                                   const Tensor* extra_add_qk,
                                   const int max_threads_per_block) const {
+  if (past_present_share_buffer_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "past_present_share_buffer is not supported");
+  }
+
   if (num_heads_ > max_threads_per_block) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
@@ -256,10 +280,25 @@ Tensor* AttentionBase::GetPresent(OpKernelContext* context,
                                   int batch_size,
                                   int head_size,
                                   int sequence_length,
-                                  int& past_sequence_length) const {
+                                  int& past_sequence_length,
+                                  const Tensor* past_seq_len) const {
   // Input and output shapes:
   //   past        : (2, batch_size, num_heads, past_sequence_length, head_size)
   //   present     : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
+  // When past_present_share_buffer is set, past and present have the same shape:
+  //   past        : (2, batch_size, num_heads, max_sequence_length, head_size)
+  //   present     : (2, batch_size, num_heads, max_sequence_length, head_size)
+
+  if (past_present_share_buffer_ && nullptr != past) {
+    // CheckInputs has validated past_seq_len
+    past_sequence_length = *past_seq_len->template Data<int32_t>();
+    Tensor* present = context->Output(1, past->Shape());
+    if (nullptr == present) {
+      ORT_THROW("Expect to have present state output when past state input is given");
+    }
+
+    return present;
+  }
 
   std::vector<int64_t> present_dims{2, batch_size, num_heads_, sequence_length, head_size};
   if (nullptr != past) {
@@ -414,6 +453,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
   const Tensor* extra_add_qk = context->Input<Tensor>(5);
+  const Tensor* past_seq_len = context->Input<Tensor>(6);
 
   const TensorShape& weights_shape = (weights ? weights->Shape() : weight_shape_);
   ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
@@ -421,7 +461,8 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
                                   bias->Shape(),
                                   mask_index,
                                   past,
-                                  extra_add_qk));
+                                  extra_add_qk,
+                                  past_seq_len));
 
   const auto shape = input->Shape().GetDims();
   const int batch_size = static_cast<int>(shape[0]);
@@ -564,7 +605,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   return ApplyAttention(Q, K, V, mask_index, past, output,
                         batch_size, sequence_length,
                         qkv_head_size[0], qkv_head_size[2], v_hidden_size,
-                        extra_add_qk, context);
+                        extra_add_qk, context, past_seq_len);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
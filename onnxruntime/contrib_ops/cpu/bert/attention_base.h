@@ -20,12 +20,15 @@ class AttentionBase {
                      const Tensor *extra_add_qk,
                      const int max_threads_per_block) const;
 
+  // When past_present_share_buffer is set, the present state has the same shape as the past state, and
+  // past_sequence_length is read from past_seq_len instead of the shape of past.
   Tensor* GetPresent(OpKernelContext* context,
                      const Tensor* past,
                      int batch_size,
                      int head_size,
                      int sequence_length,
-                     int& past_sequence_length) const;
+                     int& past_sequence_length,
+                     const Tensor* past_seq_len = nullptr) const;
 
  protected:
   AttentionBase(const OpKernelInfo& info) {
@@ -35,6 +38,8 @@ class AttentionBase {
 
     is_unidirectional_ = info.GetAttrOrDefault<int64_t>("unidirectional", 0) == 1;
 
+    past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0) == 1;
+
     if (!info.GetAttrs<int64_t>("qkv_hidden_sizes", qkv_hidden_sizes_).IsOK() || qkv_hidden_sizes_.empty()) {
       qkv_hidden_sizes_.resize(0);
     }
@@ -45,12 +50,21 @@ class AttentionBase {
                      const TensorShape& bias_shape,
                      const Tensor*& mask_index,  // For dummy mask with shape (1, 1) or (batch_size, 1), it will be updated to nullptr.
                      const Tensor* past,
-                     const Tensor *extra_add_qk) const;
+                     const Tensor *extra_add_qk,
+                     const Tensor* past_seq_len = nullptr) const;
 
   int num_heads_;           // number of attention heads
   bool is_unidirectional_;  // whether every token can only attend to previous tokens.
+  bool past_present_share_buffer_;  // whether past and present state use a buffer with capacity for max sequence length
   std::vector<int64_t> qkv_hidden_sizes_;   // Q, K, V path hidden layer sizes
 };
 
+namespace attention {
+// Environment variable to set the minimum sequence_length x total_sequence_length for which the CPU kernel uses the
+// tiled attention, which streams K and V in blocks instead of materializing the attention probs.
+constexpr const char* kMinimumTiledScoreSize = "ORT_ATTENTION_MIN_TILED_SCORE_SIZE";
+constexpr int64_t kDefaultMinimumTiledScoreSize = 1024 * 1024;
+}  // namespace attention
+
 }  // namespace contrib
 }  // namespace onnxruntime
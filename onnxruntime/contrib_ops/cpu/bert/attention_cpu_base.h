@@ -9,6 +9,7 @@
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env_var_utils.h"
 //TODO: fix the warnings
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
@@ -20,7 +21,10 @@ namespace contrib {
 
 class AttentionCPUBase : public AttentionBase {
  protected:
-  AttentionCPUBase(const OpKernelInfo& info) : AttentionBase(info) {}
+  AttentionCPUBase(const OpKernelInfo& info) : AttentionBase(info) {
+    min_tiled_score_size_ = ParseEnvironmentVariableWithDefault<int64_t>(attention::kMinimumTiledScoreSize,
+                                                                         attention::kDefaultMinimumTiledScoreSize);
+  }
 
   template <typename T>
   Status ApplyAttention(const T* Q,                  // Q data. Its size is BxNxSxH
@@ -35,18 +39,50 @@ class AttentionCPUBase : public AttentionBase {
                         int v_head_size,             // head_size
                         int v_hidden_size,           // hidden_size
                         const Tensor* extra_add_qk,  // extra add in QK. Its size is BxNxSxS
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        const Tensor* past_seq_len = nullptr  // past sequence length when past and present share buffer
+  ) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
     auto* tp = context->GetOperatorThreadPool();
 
     int past_sequence_length = 0;
-    Tensor* present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length);
+    Tensor* present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length,
+                                 past_seq_len);
+
+    // When past and present share a buffer, each state chunk has capacity for max_sequence_length tokens and the
+    // present state is appended in place after the valid past tokens, so the past state is not copied.
+    const int max_sequence_length =
+        (past_present_share_buffer_ && past != nullptr) ? static_cast<int>(past->Shape()[3]) : 0;
 
     // Total sequence length including that of past state: S* = S' + S
     const int all_sequence_length = past_sequence_length + sequence_length;
 
+    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
+
+    const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
+    gsl::span<const int64_t> mask_index_dims = mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{};
+    const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
+    T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
+
+    const T* extra_add_qk_data = nullptr;
+    if (extra_add_qk != nullptr) {
+      extra_add_qk_data = extra_add_qk->template Data<T>();
+    }
+
+    // The attention probs of all heads take B x N x S x S* elements, which is hundreds of MB for long sequences.
+    // Stream K and V in blocks with an online softmax instead, so that only a block of scores is live per task.
+    if (static_cast<int64_t>(sequence_length) * all_sequence_length >= min_tiled_score_size_ &&
+        mask_index_dims.size() != 4) {
+      ComputeTiledAttention(output->template MutableData<T>(), Q, K, V,
+                            mask_index_data, mask_index_dims, has_unidirectional,
+                            batch_size, sequence_length, past_sequence_length, max_sequence_length,
+                            qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size, v_hidden_size,
+                            past_data, present_data, extra_add_qk_data, tp);
+      return Status::OK();
+    }
+
     // Compute the attention score. It does 2 things:
     //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
     //                                           1 x mask_data(B, N, S, S*)
@@ -55,8 +91,6 @@ class AttentionCPUBase : public AttentionBase {
     auto attention_probs = allocator->Alloc(attention_probs_bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || has_unidirectional) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * all_sequence_length * sizeof(T);
@@ -65,19 +99,10 @@ class AttentionCPUBase : public AttentionBase {
     }
     BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
 
-    const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
-    gsl::span<const int64_t> mask_index_dims = mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{};
-    const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
-    T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
-
-    const T* extra_add_qk_data = nullptr;
-    if (extra_add_qk != nullptr) {
-      extra_add_qk_data = extra_add_qk->template Data<T>();
-    }
-
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data), has_unidirectional,
-                             batch_size, sequence_length, past_sequence_length, qk_head_size == 0 ? v_head_size : qk_head_size,
+                             batch_size, sequence_length, past_sequence_length, max_sequence_length,
+                             qk_head_size == 0 ? v_head_size : qk_head_size,
                              past_data, present_data, tp, extra_add_qk_data);
 
     // Compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
@@ -86,8 +111,8 @@ class AttentionCPUBase : public AttentionBase {
     BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
 
     ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
-                            batch_size, sequence_length, past_sequence_length, v_head_size, v_hidden_size,
-                            past_data, present_data, tp);
+                            batch_size, sequence_length, past_sequence_length, max_sequence_length,
+                            v_head_size, v_hidden_size, past_data, present_data, tp);
 
     return Status::OK();
   }
@@ -108,6 +133,7 @@ class AttentionCPUBase : public AttentionBase {
                              int batch_size,                               // batch size of self-attention
                              int sequence_length,                          // sequence length of self-attention
                              int past_sequence_length,                     // sequence length of past state
+                             int max_sequence_length,                      // capacity of shared past and present state. 0 if not shared
                              int head_size,                                // head size of self-attention
                              const T* past,                                // past state
                              T* present,                                   // present state
@@ -118,6 +144,7 @@ class AttentionCPUBase : public AttentionBase {
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length) * head_size;      // S x H
     const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t max_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;    // M x H
 
     {
       if (mask_data != nullptr) {
@@ -147,8 +174,13 @@ class AttentionCPUBase : public AttentionBase {
 
           const T* k = K + input_chunk_length * i;
           if (nullptr != present) {
-            // Concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
-            k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
+            if (max_chunk_length > 0) {
+              // Append K after past_K in the shared buffer: (BxNx)SxH -> (BxNx)MxH
+              k = AppendStateChunk(past, k, present, past_chunk_length, input_chunk_length, max_chunk_length, i);
+            } else {
+              // Concatenate past_K and K : (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
+              k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
+            }
           }
 
           // Compute Q*K' + AttentionMask
@@ -195,6 +227,7 @@ class AttentionCPUBase : public AttentionBase {
                                int batch_size,            // batch size
                                int sequence_length,       // sequence length
                                int past_sequence_length,  // sequence length in past state
+                               int max_sequence_length,   // capacity of shared past and present state. 0 if not shared
                                int head_size,             // head size
                                int hidden_size,           // hidden size
                                const T* past,             // past state
@@ -204,13 +237,16 @@ class AttentionCPUBase : public AttentionBase {
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
     const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+    const size_t max_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;    // M x H
 
     // Move the pointer of past and present to start of v values.
+    const size_t past_state_length = max_chunk_length > 0 ? max_chunk_length : past_chunk_length;
+    const size_t present_state_length = max_chunk_length > 0 ? max_chunk_length : present_chunk_length;
     if (nullptr != past) {
-      past += batch_size * num_heads_ * past_sequence_length * head_size;
+      past += static_cast<size_t>(batch_size) * num_heads_ * past_state_length;
     }
     if (nullptr != present) {
-      present += batch_size * num_heads_ * all_sequence_length * head_size;
+      present += static_cast<size_t>(batch_size) * num_heads_ * present_state_length;
     }
 
     const double cost =
@@ -220,8 +256,13 @@ class AttentionCPUBase : public AttentionBase {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const T* v = V + input_chunk_length * i;
         if (nullptr != present) {
-          // concatenate past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
-          v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
+          if (max_chunk_length > 0) {
+            // Append V after past_V in the shared buffer: (BxNx)SxH -> (BxNx)MxH
+            v = AppendStateChunk(past, v, present, past_chunk_length, input_chunk_length, max_chunk_length, i);
+          } else {
+            // concatenate past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
+            v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
+          }
         }
 
         T* current_tmp_data = reinterpret_cast<T*>(tmp_buffer) + input_chunk_length * i;
@@ -243,6 +284,193 @@ class AttentionCPUBase : public AttentionBase {
       }
     });
   }
+
+  // Helper function to compute the attention without materializing the attention probs. Each task handles a block of
+  // query rows of one head and streams the K and V blocks of that head:
+  //   scores(Sq, Sk) = 1/sqrt(H) x Q(Sq, H) x K'(H, Sk) + mask(Sq, Sk)
+  //   out(Sq, H_v) = out x exp(old_max - new_max) + exp(scores - new_max) x V(Sk, H_v)
+  // with a running max and sum of each row (online softmax), and out is divided by the sum at the end.
+  template <typename T>
+  void ComputeTiledAttention(T* output,                                // output buffer with size BxSxNxH_v
+                             const T* Q,                               // Q data. Its size is BxNxSxH
+                             const T* K,                               // k data. Its size is BxNxSxH
+                             const T* V,                               // V value with size BxNxSxH_v
+                             const int32_t* mask_index,                // mask index. nullptr if no mask
+                             gsl::span<const int64_t> mask_index_dims,  // mask index shape
+                             bool has_unidirectional,                  // has unidirectional mask
+                             int batch_size,                           // batch size of self-attention
+                             int sequence_length,                      // sequence length of self-attention
+                             int past_sequence_length,                 // sequence length of past state
+                             int max_sequence_length,                  // capacity of shared past and present state. 0 if not shared
+                             int qk_head_size,                         // head size of Q and K
+                             int v_head_size,                          // head size of V
+                             int v_hidden_size,                        // hidden size of the output
+                             const T* past,                            // past state
+                             T* present,                               // present state
+                             const T* extra_add_qk_data,               // extra add matrix with shape BxNxSxS*
+                             ThreadPool* tp) const {
+    constexpr int query_block_size = 64;
+    constexpr int key_block_size = 256;
+
+    const int all_sequence_length = past_sequence_length + sequence_length;  // S* = S' + S
+    const int loop_len = batch_size * num_heads_;
+
+    // Gather K and V of each head, concatenated with the past state when there is one.
+    std::vector<const T*> k_heads(loop_len);
+    std::vector<const T*> v_heads(loop_len);
+    {
+      const size_t k_past_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;  // S' x H
+      const size_t k_input_chunk_length = static_cast<size_t>(sequence_length) * qk_head_size;      // S x H
+      const size_t k_max_chunk_length = static_cast<size_t>(max_sequence_length) * qk_head_size;    // M x H
+      const size_t v_past_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;   // S' x H_v
+      const size_t v_input_chunk_length = static_cast<size_t>(sequence_length) * v_head_size;       // S x H_v
+      const size_t v_max_chunk_length = static_cast<size_t>(max_sequence_length) * v_head_size;     // M x H_v
+
+      // Move the pointer of past and present to start of v values.
+      const T* past_v = nullptr;
+      T* present_v = nullptr;
+      if (nullptr != past) {
+        past_v = past + static_cast<size_t>(loop_len) *
+                            (v_max_chunk_length > 0 ? v_max_chunk_length : v_past_chunk_length);
+      }
+      if (nullptr != present) {
+        present_v = present + static_cast<size_t>(loop_len) *
+                                  (v_max_chunk_length > 0 ? v_max_chunk_length : v_past_chunk_length + v_input_chunk_length);
+      }
+
+      const double cost = static_cast<double>(all_sequence_length) * (qk_head_size + v_head_size);
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const T* k = K + k_input_chunk_length * i;
+          const T* v = V + v_input_chunk_length * i;
+          if (nullptr != present) {
+            if (k_max_chunk_length > 0) {
+              k = AppendStateChunk(past, k, present, k_past_chunk_length, k_input_chunk_length, k_max_chunk_length, i);
+              v = AppendStateChunk(past_v, v, present_v, v_past_chunk_length, v_input_chunk_length, v_max_chunk_length, i);
+            } else {
+              k = ConcatStateChunk(past, k, present, k_past_chunk_length, k_past_chunk_length + k_input_chunk_length, i);
+              v = ConcatStateChunk(past_v, v, present_v, v_past_chunk_length, v_past_chunk_length + v_input_chunk_length, i);
+            }
+          }
+          k_heads[i] = k;
+          v_heads[i] = v;
+        }
+      });
+    }
+
+    const bool has_mask = (nullptr != mask_index || has_unidirectional);
+    const int query_block_count = (sequence_length + query_block_size - 1) / query_block_size;
+    const T alpha = static_cast<T>(1.0f / sqrt(static_cast<float>(qk_head_size)));
+
+    // The cost of the Gemms of a block of query rows
+    const double cost = static_cast<double>(query_block_size) * all_sequence_length * (qk_head_size + v_head_size);
+
+    ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(loop_len) * query_block_count, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<T> scores(static_cast<size_t>(query_block_size) * key_block_size);
+      std::vector<T> mask_row(has_mask ? key_block_size : 0);
+      std::vector<T> out(static_cast<size_t>(query_block_size) * v_head_size);
+      std::vector<T> row_max(query_block_size);
+      std::vector<T> row_sum(query_block_size);
+
+      for (std::ptrdiff_t task = begin; task != end; ++task) {
+        const std::ptrdiff_t i = task / query_block_count;
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int q_begin = static_cast<int>(task % query_block_count) * query_block_size;
+        const int q_count = std::min(query_block_size, sequence_length - q_begin);
+
+        const T* q = Q + (static_cast<size_t>(i) * sequence_length + q_begin) * qk_head_size;
+        const T* k = k_heads[i];
+        const T* v = v_heads[i];
+
+        std::fill_n(out.data(), static_cast<size_t>(q_count) * v_head_size, static_cast<T>(0.0f));
+        std::fill_n(row_max.data(), q_count, std::numeric_limits<T>::lowest());
+        std::fill_n(row_sum.data(), q_count, static_cast<T>(0.0f));
+
+        for (int k_begin = 0; k_begin < all_sequence_length; k_begin += key_block_size) {
+          const int k_count = std::min(key_block_size, all_sequence_length - k_begin);
+
+          // scores = 1/sqrt(H) x Q x K'
+          math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, q_count, k_count, qk_head_size, alpha,
+                                    q, k + static_cast<size_t>(k_begin) * qk_head_size, 0.0f,
+                                    scores.data(), nullptr);
+
+          for (int r = 0; r < q_count; r++) {
+            const int s_i = q_begin + r;
+            T* row = scores.data() + static_cast<size_t>(r) * k_count;
+
+            if (has_mask) {
+              PrepareMaskRow(mask_index, mask_index_dims, mask_row.data(), has_unidirectional,
+                             batch_size, sequence_length, past_sequence_length, batch_index, s_i,
+                             k_begin, k_begin + k_count);
+              // The score of a future position is replaced by the mask, for parity with ComputeAttentionProbs.
+              const int future_begin = has_unidirectional ? past_sequence_length + s_i + 1 - k_begin : k_count;
+              for (int c = 0; c < k_count; c++) {
+                row[c] = (c >= future_begin) ? mask_row[c] : row[c] + mask_row[c];
+              }
+            }
+
+            if (extra_add_qk_data != nullptr) {
+              const T* extra_add_row = extra_add_qk_data + (static_cast<size_t>(i) * sequence_length + s_i) * all_sequence_length + k_begin;
+              for (int c = 0; c < k_count; c++) {
+                row[c] += extra_add_row[c];
+              }
+            }
+
+            T block_max = row_max[r];
+            for (int c = 0; c < k_count; c++) {
+              block_max = std::max(block_max, row[c]);
+            }
+
+            for (int c = 0; c < k_count; c++) {
+              row[c] -= block_max;
+            }
+            if constexpr (std::is_same<T, float>::value) {
+              MlasComputeExp(row, row, static_cast<size_t>(k_count));
+            } else {
+              for (int c = 0; c < k_count; c++) {
+                row[c] = std::exp(row[c]);
+              }
+            }
+
+            T block_sum = 0;
+            for (int c = 0; c < k_count; c++) {
+              block_sum += row[c];
+            }
+
+            // Rescale the partial result of the previous blocks to the new maximum.
+            const T factor = std::exp(row_max[r] - block_max);
+            if (factor != static_cast<T>(1.0f)) {
+              T* out_row = out.data() + static_cast<size_t>(r) * v_head_size;
+              for (int h = 0; h < v_head_size; h++) {
+                out_row[h] *= factor;
+              }
+            }
+            row_sum[r] = row_sum[r] * factor + block_sum;
+            row_max[r] = block_max;
+          }
+
+          // out += exp(scores - max) x V
+          math::Gemm<T, ThreadPool>(CblasNoTrans, CblasNoTrans, q_count, v_head_size, k_count, 1.0f,
+                                    scores.data(), v + static_cast<size_t>(k_begin) * v_head_size, 1.0f,
+                                    out.data(), nullptr);
+        }
+
+        // Normalize and transpose: out(B, S, N, H_v) = out_tmp(B, N, S, H_v)
+        for (int r = 0; r < q_count; r++) {
+          const T inverse_sum = static_cast<T>(1.0f) / row_sum[r];
+          const T* src = out.data() + static_cast<size_t>(r) * v_head_size;
+          T* dest = output + (static_cast<size_t>(batch_index) * sequence_length + q_begin + r) * v_hidden_size +
+                    static_cast<size_t>(head_index) * v_head_size;
+          for (int h = 0; h < v_head_size; h++) {
+            dest[h] = src[h] * inverse_sum;
+          }
+        }
+      }
+    });
+  }
+
+  int64_t min_tiled_score_size_;  // minimum S x S* to compute the attention with ComputeTiledAttention
 };
 
 }  // namespace contrib
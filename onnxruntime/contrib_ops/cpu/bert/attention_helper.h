@@ -147,6 +147,53 @@ void PrepareMask(const int32_t* mask_index,
   }
 }
 
+// Compute columns [m_begin, m_end) of row s_i of batch b_i of the mask, which are the values PrepareMask writes to
+// mask_data at the same position. It is used when the BxSxS* mask is not materialized.
+template <typename T>
+void PrepareMaskRow(const int32_t* mask_index,
+                    gsl::span<const int64_t> mask_index_dims,
+                    T* p_mask,
+                    bool is_unidirectional,
+                    int batch_size,
+                    int sequence_length,
+                    int past_sequence_length,
+                    int b_i,
+                    int s_i,
+                    int m_begin,
+                    int m_end) {
+  const int all_sequence_length = past_sequence_length + sequence_length;
+  const int count = m_end - m_begin;
+
+  if (nullptr == mask_index) {
+    std::fill_n(p_mask, count, static_cast<T>(0.0f));
+  } else if (mask_index_dims.size() == 3 || mask_index_dims.size() == 2) {
+    // 3D mask is (B)xSxS* and raw attention mask is (B)xS*, both with value 0 or 1.
+    const int32_t* raw_mask = mask_index + (mask_index_dims.size() == 3
+                                                ? (static_cast<ptrdiff_t>(b_i) * sequence_length + s_i) * all_sequence_length
+                                                : static_cast<ptrdiff_t>(b_i) * all_sequence_length);
+    for (int m_i = m_begin; m_i < m_end; m_i++) {
+      p_mask[m_i - m_begin] = (raw_mask[m_i] > 0) ? static_cast<T>(0.0f) : static_cast<T>(-10000.0f);
+    }
+  } else {
+    // mask_index is 1D: (B) or (2B)
+    const int end_position = mask_index[b_i];
+    int start_position = 0;
+    if (static_cast<int>(mask_index_dims.at(0)) == 2 * batch_size) {
+      start_position = std::min(mask_index[b_i + batch_size], all_sequence_length);
+    }
+    for (int m_i = m_begin; m_i < m_end; m_i++) {
+      p_mask[m_i - m_begin] = (m_i >= end_position || m_i < start_position) ? static_cast<T>(-10000.0f)
+                                                                              : static_cast<T>(0.0f);
+    }
+  }
+
+  if (is_unidirectional) {
+    for (int m_i = std::max(m_begin, past_sequence_length + s_i + 1); m_i < m_end; m_i++) {
+      p_mask[m_i - m_begin] += static_cast<T>(-10000.0f);
+    }
+  }
+}
+
 // Concatenate a past state chunk S'xH with input state chunk SxH into present state chunk S*xH
 // Returns a pointer to the start of present state chunk.
 template <typename T>
@@ -164,5 +211,23 @@ T* ConcatStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk
   return start;
 }
 
+// Append input state chunk SxH after the first S' rows of a present state chunk with capacity for M rows.
+// Past and present state chunks have the same capacity. When they are different buffers, the S' rows in use of the
+// past state chunk are copied to the present state chunk first, so the cost of a step does not depend on M.
+// Returns a pointer to the start of present state chunk.
+template <typename T>
+T* AppendStateChunk(const T* past, const T* chunk, T* present, size_t past_chunk_length, size_t input_chunk_length,
+                    size_t max_chunk_length, std::ptrdiff_t i) {
+  T* start = present + i * max_chunk_length;
+
+  const T* src_past = past + i * max_chunk_length;
+  if (src_past != start) {
+    memcpy(start, src_past, past_chunk_length * sizeof(T));
+  }
+
+  memcpy(start + past_chunk_length, chunk, input_chunk_length * sizeof(T));
+  return start;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
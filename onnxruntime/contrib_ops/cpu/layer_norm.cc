@@ -5,6 +5,7 @@
 
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -101,35 +102,42 @@ Status LayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
         const T* p_input = X_data + task_idx * norm_size;
         T* p_output = Y_data + task_idx * norm_size;
 
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon_);
+        if constexpr (std::is_same<T, float>::value) {
+          MlasComputeLayerNorm(p_input, nullptr, nullptr, nullptr, scale_data, bias_data, p_output,
+                               static_cast<size_t>(norm_size), epsilon_, simplified,
+                               mean_data != nullptr ? mean_data + task_idx : nullptr,
+                               inv_std_dev_data + task_idx);
         } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
-        }
+          T mean = 0;
+          T mean_square = 0;
+
+          for (int64_t h = 0; h < norm_size; h++) {
+            mean += p_input[h];
+            mean_square += p_input[h] * p_input[h];
+          }
 
-        for (int64_t h = 0; h < norm_size; h++) {
+          mean = mean / norm_size;
           if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            mean_square = sqrt(mean_square / norm_size + epsilon_);
           } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon_);
           }
-        }
 
-        if (mean_data != nullptr) {
-          mean_data[task_idx] = mean;
+          for (int64_t h = 0; h < norm_size; h++) {
+            if (simplified) {
+              p_output[h] = p_input[h] / mean_square * scale_data[h];
+            } else if (nullptr == bias) {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            } else {
+              p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            }
+          }
+
+          if (mean_data != nullptr) {
+            mean_data[task_idx] = mean;
+          }
+          inv_std_dev_data[task_idx] = 1 / mean_square;
         }
-        inv_std_dev_data[task_idx] = 1 / mean_square;
       },
       0);
 
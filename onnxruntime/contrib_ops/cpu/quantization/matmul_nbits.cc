@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul with weight only blockwise quantized B. The activations stay float and MLAS dequantizes B a cache block at
+// a time inside the GEMM, so only the 4-bit or 8-bit weights are read from memory.
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info)
+      : OpKernel(info),
+        K_{gsl::narrow<size_t>(info.GetAttr<int64_t>("K"))},
+        N_{gsl::narrow<size_t>(info.GetAttr<int64_t>("N"))},
+        block_size_{gsl::narrow<size_t>(info.GetAttr<int64_t>("block_size"))},
+        nbits_{gsl::narrow<size_t>(info.GetAttrOrDefault<int64_t>("bits", 4))} {
+    ORT_ENFORCE(MlasIsQNBitGemmAvailable(nbits_, block_size_),
+                "MatMulNBits: unsupported bits ", nbits_, " or block_size ", block_size_,
+                ". bits must be 4 or 8 and block_size a power of 2 in [16, 256].");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum InputTensors : int {
+    IN_A = 0,
+    IN_B = 1,
+    IN_SCALES = 2,
+    IN_ZERO_POINTS = 3,
+    IN_BIAS = 4
+  };
+
+ private:
+  const size_t K_;
+  const size_t N_;
+  const size_t block_size_;
+  const size_t nbits_;
+};
+
+Status MatMulNBits::Compute(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(IN_A);
+  const Tensor* b = ctx->Input<Tensor>(IN_B);
+  const Tensor* scales = ctx->Input<Tensor>(IN_SCALES);
+  const Tensor* zero_points = ctx->Input<Tensor>(IN_ZERO_POINTS);
+  const Tensor* bias = ctx->Input<Tensor>(IN_BIAS);
+
+  const TensorShape& a_shape = a->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 1 && static_cast<size_t>(a_shape[a_shape.NumDimensions() - 1]) == K_,
+                    "MatMulNBits: the last dimension of input A must be K=", K_, ", got shape ", a_shape);
+
+  size_t quant_b_data_size;
+  size_t quant_b_scale_count;
+  size_t quant_b_zero_point_size;
+  MlasQNBitGemmQuantBSizes(N_, K_, nbits_, block_size_,
+                           &quant_b_data_size, &quant_b_scale_count, &quant_b_zero_point_size);
+
+  ORT_RETURN_IF_NOT(static_cast<size_t>(b->Shape().Size()) == quant_b_data_size,
+                    "MatMulNBits: input B must have ", quant_b_data_size, " elements, got shape ", b->Shape());
+  ORT_RETURN_IF_NOT(static_cast<size_t>(scales->Shape().Size()) == quant_b_scale_count,
+                    "MatMulNBits: input scales must have ", quant_b_scale_count, " elements, got shape ",
+                    scales->Shape());
+  if (zero_points != nullptr) {
+    ORT_RETURN_IF_NOT(static_cast<size_t>(zero_points->Shape().Size()) == quant_b_zero_point_size,
+                      "MatMulNBits: input zero_points must have ", quant_b_zero_point_size,
+                      " elements, got shape ", zero_points->Shape());
+  }
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(static_cast<size_t>(bias->Shape().Size()) == N_,
+                      "MatMulNBits: input bias must have N=", N_, " elements, got shape ", bias->Shape());
+  }
+
+  TensorShapeVector y_dims = a_shape.AsShapeVector();
+  y_dims.back() = static_cast<int64_t>(N_);
+  Tensor* y = ctx->Output(0, TensorShape(y_dims));
+
+  // All leading dimensions of A are rows of a single GEMM.
+  const size_t M = static_cast<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+  if (M == 0 || N_ == 0) {
+    return Status::OK();
+  }
+
+  MLAS_QNBIT_GEMM_DATA_PARAMS data;
+  data.A = a->Data<float>();
+  data.lda = K_;
+  data.QuantBData = b->Data<uint8_t>();
+  data.QuantBScale = scales->Data<float>();
+  data.QuantBZeroPoint = zero_points != nullptr ? zero_points->Data<uint8_t>() : nullptr;
+  data.Bias = bias != nullptr ? bias->Data<float>() : nullptr;
+  data.C = y->MutableData<float>();
+  data.ldc = N_;
+
+  MlasQNBitGemmBatch(M, N_, K_, 1, nbits_, block_size_, &data, ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -105,27 +106,32 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
         const T* p_skip = skip_data + task_idx * hidden_size;
         T* p_output = output_data + task_idx * hidden_size;
 
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
-          if (nullptr != bias_data) {
-            value += bias_data[h];
+        if constexpr (std::is_same<T, float>::value) {
+          MlasComputeLayerNorm(p_input, p_skip, bias_data, nullptr, gamma_data, beta_data, p_output,
+                               static_cast<size_t>(hidden_size), epsilon_, false, nullptr, nullptr);
+        } else {
+          T mean = 0;
+          T mean_square = 0;
+
+          for (int64_t h = 0; h < hidden_size; h++) {
+            T value = p_input[h] + p_skip[h];
+            if (nullptr != bias_data) {
+              value += bias_data[h];
+            }
+            p_output[h] = value;
+            mean += value;
+            mean_square += value * value;
           }
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
 
-        mean = mean / hidden_size;
-        mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
+          mean = mean / hidden_size;
+          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
 
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+          for (int64_t h = 0; h < hidden_size; h++) {
+            if (nullptr == beta_data) {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+            } else {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+            }
           }
         }
       },
@@ -5,7 +5,12 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
+#include "re2/set.h"
+
+#include <algorithm>
+#include <mutex>
 
 namespace onnxruntime {
 namespace contrib {
@@ -30,11 +35,24 @@ class Tokenizer final : public OpKernel {
                          size_t N, size_t C,
                          gsl::span<const int64_t> input_dims) const;
 
+  // Splits one input string with separators_ or matches regex_ in it. The tokens are views of s.
+  Status SeparatorExpressionTokenizeRow(const std::string& s, std::vector<re2::StringPiece>& row) const;
+  Status TokenExpressionRow(const std::string& s, std::vector<re2::StringPiece>& row) const;
+
+  // Writes the tokens of every row, with markers and padding, as the last dimension of the output.
+  Status OutputTokens(OpKernelContext* ctx, const std::vector<std::vector<re2::StringPiece>>& rows,
+                      gsl::span<const int64_t> input_dims) const;
+
   bool mark_{false};
   std::string pad_value_;
   int64_t mincharnum_{0};
   bool char_tokenezation_{false};
   std::vector<std::unique_ptr<re2::RE2>> separators_;
+  // All the separators in one automaton, which finds the ones that occur in a string with a single scan of it.
+  // Separators that do not occur in a string can not split any of its tokens and are skipped, unless they have
+  // assertions (anchors or word boundaries) that could match at the edges of a token but not inside the string.
+  std::unique_ptr<re2::RE2::Set> separator_set_;
+  std::vector<bool> separator_has_assertions_;
   std::unique_ptr<re2::RE2> regex_;
 };
 
@@ -51,6 +69,46 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 namespace tokenizer_details {
 constexpr char start_text = 0x2;
 constexpr char end_text = 0x3;
+
+// Conservative check for the zero width assertions of the RE2 syntax. A false positive only disables skipping.
+bool HasAssertions(const std::string& pattern) {
+  return pattern.find_first_of("^$") != std::string::npos ||
+         pattern.find("\\b") != std::string::npos || pattern.find("\\B") != std::string::npos ||
+         pattern.find("\\A") != std::string::npos || pattern.find("\\z") != std::string::npos;
+}
+
+// Calls fn(row) for every input string, splitting the rows across the thread pool. The cost of a row is taken
+// to be proportional to the length of its string. Returns the error of the first row that fails.
+template <typename Fn>
+Status ParallelForRows(concurrency::ThreadPool* tp, const std::string* input, size_t count,
+                       double cycles_per_byte, Fn&& fn) {
+  size_t total_length = 0;
+  for (size_t i = 0; i < count; ++i) {
+    total_length += input[i].size();
+  }
+  const double average_length = static_cast<double>(total_length) / static_cast<double>(count) + 1.0;
+
+  std::mutex mutex;
+  size_t failed_row = count;
+  Status status;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(count),
+      TensorOpCost{average_length, average_length, average_length * cycles_per_byte},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          Status row_status = fn(static_cast<size_t>(i));
+          if (!row_status.IsOK()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (static_cast<size_t>(i) < failed_row) {
+              failed_row = static_cast<size_t>(i);
+              status = std::move(row_status);
+            }
+            return;
+          }
+        }
+      });
+  return status;
+}
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
@@ -92,12 +150,21 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
     if (!separators.empty()) {
       re2::RE2::Options options;
       options.set_longest_match(true);
+      separator_set_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::UNANCHORED);
       for (const auto& sep : separators) {
         std::unique_ptr<re2::RE2> regex = std::make_unique<re2::RE2>(sep, options);
         if (!regex->ok()) {
           ORT_THROW("Can not digest separators: ", sep, " ", regex->error());
         }
         separators_.push_back(std::move(regex));
+        separator_has_assertions_.push_back(HasAssertions(sep));
+        if (separator_set_ != nullptr && separator_set_->Add(sep, nullptr) < 0) {
+          separator_set_.reset();
+        }
+      }
+      // Without the set every separator is applied to every string, which gives the same tokens
+      if (separator_set_ != nullptr && !separator_set_->Compile()) {
+        separator_set_.reset();
       }
     } else {
       // Use tokenexp
@@ -118,13 +185,13 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   // With char tokenzation we get as many tokens as the number of
   // utf8 characters in the string. So for every string we calculate its character(utf8) length
   // add padding and add start/end test separators if necessary
-  size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  std::vector<size_t> row_tokens(N * C);
+  auto status = ParallelForRows(tp, input_data, N * C, 1.0, [&](size_t row) {
+    const auto& s = input_data[row];
     size_t tokens = 0;  // length in utf8 chars
     if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
                        tokens)) {
@@ -133,9 +200,12 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                     "Input string contains invalid utf8 chars");
     }
-    max_tokens = std::max(max_tokens, tokens);
-    ++curr_input;
-  }
+    row_tokens[row] = tokens;
+    return Status::OK();
+  });
+  ORT_RETURN_IF_ERROR(status);
+
+  size_t max_tokens = *std::max_element(row_tokens.cbegin(), row_tokens.cend());
 
   std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
   // Check if we have no output due to apparently empty strings input.
@@ -154,15 +224,14 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
   TensorShape output_shape(output_dims);
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
-  size_t output_index = 0;
-  curr_input = input_data;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+
+  // Every row owns max_tokens output strings, so the rows are written independently
+  return ParallelForRows(tp, input_data, N * C, 1.0, [&](size_t row) {
+    const auto& s = input_data[row];
+    auto* output = output_data + row * max_tokens;
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      (output++)->assign(&start_text, 1);
     }
-    size_t tokens = 0;
     const size_t str_len = s.size();
     for (size_t token_idx = 0; token_idx < str_len;) {
       size_t tlen = 0;
@@ -170,236 +239,212 @@ Status Tokenizer::CharTokenize(OpKernelContext* ctx, size_t N, size_t C,
       assert(result);
       (void)result;
       assert(token_idx + tlen <= str_len);
-      *(output_data + output_index) = s.substr(token_idx, tlen);
-      ++output_index;
+      (output++)->assign(s, token_idx, tlen);
       token_idx += tlen;
-      ++tokens;
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      (output++)->assign(&end_text, 1);
     }
     // Padding strings
-    assert(tokens + (static_cast<size_t>(mark_) * 2) <= max_tokens);
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - tokens;
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-    ++curr_input;
-  }
-  return Status::OK();
+    assert(row_tokens[row] + (static_cast<size_t>(mark_) * 2) <= max_tokens);
+    std::fill(output, output_data + (row + 1) * max_tokens, pad_value_);
+    return Status::OK();
+  });
 }
 
-Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
-                                               size_t N, size_t C,
-                                               gsl::span<const int64_t> input_dims) const {
+Status Tokenizer::SeparatorExpressionTokenizeRow(const std::string& s,
+                                                 std::vector<re2::StringPiece>& row) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
 
   // We do not constraint the search to match
   // on the beginning or end of the string
   const RE2::Anchor anchor = RE2::UNANCHORED;
 
-  // Scan all strings and attempt to find separators in them
-  // collect all the output tokens here
-  size_t max_tokens = 0;
-  auto X = ctx->Input<Tensor>(0);
-  auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
-  while (curr_input != last) {
-    const auto& s = *curr_input;
-    size_t utf8_chars = 0;  // length in utf8 chars
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
+  size_t utf8_chars = 0;  // length in utf8 chars
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
+  }
+
+  // Find the separators that occur in the string. If the set can not tell, every separator is applied.
+  std::vector<int> found_separators;
+  bool apply_all = true;
+  if (separator_set_ != nullptr) {
+    RE2::Set::ErrorInfo error_info;
+    if (separator_set_->Match(s, &found_separators, &error_info) || error_info.kind == RE2::Set::kNoError) {
+      std::sort(found_separators.begin(), found_separators.end());
+      apply_all = false;
     }
+  }
 
-    std::vector<StringPiece> row{s};
-
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
-      for (const auto& text : row) {
-        const auto end_pos = text.length();
-        size_t start_pos = 0;
-        StringPiece submatch;
-
-        bool match = true;
-        do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-          if (match) {
-            // Record  pos/len
-            assert(submatch.data() != nullptr);
-            size_t match_pos = submatch.data() - text.data();
-            assert(match_pos >= start_pos);
-            auto token_len = match_pos - start_pos;
-            utf8_chars = 0;
-            bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                                  token_len, utf8_chars);
-            if (!valid) {
-              return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "Match contains invalid utf8 chars: " + submatch.as_string());
-            }
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, token_len);
-            }
-            // Update starting position
-            // Guard against empty string match
-            auto match_len = submatch.length();
-            if (match_len > 0) {
-              start_pos = match_pos + match_len;
-            } else {
-              size_t bytes = 0;
-              utf8_bytes(*submatch.data(), bytes);
-              start_pos = match_pos + bytes;
-            }
+  row.assign(1, StringPiece(s));
+  bool applied_any = false;
+
+  std::vector<StringPiece> tokens;
+  for (size_t sep_idx = 0; sep_idx < separators_.size(); ++sep_idx) {
+    if (!apply_all && !separator_has_assertions_[sep_idx] &&
+        !std::binary_search(found_separators.cbegin(), found_separators.cend(), static_cast<int>(sep_idx))) {
+      continue;
+    }
+    applied_any = true;
+
+    const auto& sep = separators_[sep_idx];
+    tokens.clear();
+    for (const auto& text : row) {
+      const auto end_pos = text.length();
+      size_t start_pos = 0;
+      StringPiece submatch;
+
+      bool match = true;
+      do {
+        match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+        if (match) {
+          // Record  pos/len
+          assert(submatch.data() != nullptr);
+          size_t match_pos = submatch.data() - text.data();
+          assert(match_pos >= start_pos);
+          auto token_len = match_pos - start_pos;
+          utf8_chars = 0;
+          bool valid = utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                                token_len, utf8_chars);
+          if (!valid) {
+            return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Match contains invalid utf8 chars: " + submatch.as_string());
+          }
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, token_len);
+          }
+          // Update starting position
+          // Guard against empty string match
+          auto match_len = submatch.length();
+          if (match_len > 0) {
+            start_pos = match_pos + match_len;
           } else {
-            // record trailing token
-            auto trailing_len = end_pos - start_pos;
-            utf8_chars = 0;
-            utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
-                     trailing_len, utf8_chars);
-            if (utf8_chars >= size_t(mincharnum_)) {
-              tokens.emplace_back(text.data() + start_pos, trailing_len);
-            }
+            size_t bytes = 0;
+            utf8_bytes(*submatch.data(), bytes);
+            start_pos = match_pos + bytes;
           }
-        } while (match);
-      }  // row
-      // Replace the row with the results of this tokenezation
-      row.swap(tokens);
-    }  // separators_
-    max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
-    ++curr_input;
+        } else {
+          // record trailing token
+          auto trailing_len = end_pos - start_pos;
+          utf8_chars = 0;
+          utf8_len(reinterpret_cast<const unsigned char*>(text.data() + start_pos),
+                   trailing_len, utf8_chars);
+          if (utf8_chars >= size_t(mincharnum_)) {
+            tokens.emplace_back(text.data() + start_pos, trailing_len);
+          }
+        }
+      } while (match);
+    }  // row
+    // Replace the row with the results of this tokenezation
+    row.swap(tokens);
+  }  // separators_
+
+  // A separator that does not match keeps the tokens that are long enough. Once one has been applied the
+  // tokens are all long enough, otherwise the whole string still has to be checked.
+  if (!applied_any) {
+    utf8_chars = 0;
+    utf8_len(reinterpret_cast<const unsigned char*>(s.data()), s.size(), utf8_chars);
+    if (utf8_chars < size_t(mincharnum_)) {
+      row.clear();
+    }
   }
+  return Status::OK();
+}
 
-  std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
-  // Check if we have no output due to either empty input
-  // everything is a separator
-  if (max_tokens == 0) {
-    output_dims.push_back(0);
-    TensorShape output_shape(output_dims);
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
+Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
+                                               size_t N, size_t C,
+                                               gsl::span<const int64_t> input_dims) const {
+  // Scan all strings and attempt to find separators in them
+  // collect all the output tokens here
+  auto X = ctx->Input<Tensor>(0);
+  auto const input_data = X->template Data<std::string>();
+  std::vector<std::vector<re2::StringPiece>> rows(N * C);
 
-  if (mark_) {
-    max_tokens += 2;  // Start/end markers as separate tokens
-  }
+  // every separator scans a row once more
+  const double cycles_per_byte = 10.0 * static_cast<double>(separators_.size());
+  auto status = ParallelForRows(ctx->GetOperatorThreadPool(), input_data, N * C, cycles_per_byte,
+                                [&](size_t row) {
+                                  return SeparatorExpressionTokenizeRow(input_data[row], rows[row]);
+                                });
+  ORT_RETURN_IF_ERROR(status);
 
-  output_dims.push_back(max_tokens);
-  TensorShape output_shape(output_dims);
+  return OutputTokens(ctx, rows, input_dims);
+}
 
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
+Status Tokenizer::TokenExpressionRow(const std::string& s, std::vector<re2::StringPiece>& row) const {
+  using namespace re2;
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  size_t output_index = 0;
-  curr_input = input_data;
-  for (auto& row : rows) {
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
-    if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
-      ++output_index;
-    }
-    if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
+  // We do not constraint the search to match
+  // on the beginning or end of the string
+  const RE2::Anchor anchor = RE2::UNANCHORED;
+
+  size_t utf8_chars = 0;
+  if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                     utf8_chars)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input string contains invalid utf8 chars: " + s);
   }
+
+  StringPiece text(s);
+  const auto end_pos = s.length();
+  size_t start_pos = 0;
+  StringPiece submatch;
+
+  bool match = true;
+  do {
+    match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+    if (match) {
+      // Record  pos/len
+      assert(submatch.data() != nullptr);
+      size_t match_pos = submatch.data() - s.data();
+      assert(match_pos >= start_pos);
+      // Guard against empty match and make
+      // sure we make progress either way
+      auto token_len = submatch.length();
+      utf8_chars = 0;
+      if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
+        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                      "Match contains invalid utf8 chars: " + submatch.as_string());
+      }
+      if (utf8_chars >= size_t(mincharnum_)) {
+        row.push_back(submatch);
+        start_pos = match_pos + token_len;
+      } else {
+        size_t bytes = 0;
+        utf8_bytes(*submatch.data(), bytes);
+        start_pos = match_pos + bytes;
+      }
+    }
+  } while (match);
   return Status::OK();
 }
 
 Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                                   size_t N, size_t C,
                                   gsl::span<const int64_t> input_dims) const {
-  using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
-
-  size_t max_tokens = 0;
+  // Represents the tokens that will be output for every input string
   auto X = ctx->Input<Tensor>(0);
   auto const input_data = X->template Data<std::string>();
-  auto curr_input = input_data;
-  auto const last = input_data + N * C;
+  std::vector<std::vector<re2::StringPiece>> rows(N * C);
 
-  // We do not constraint the search to match
-  // on the beginning or end of the string
-  const RE2::Anchor anchor = RE2::UNANCHORED;
-
-  while (curr_input != last) {
-    const auto& s = *curr_input;
+  auto status = ParallelForRows(ctx->GetOperatorThreadPool(), input_data, N * C, 10.0,
+                                [&](size_t row) {
+                                  return TokenExpressionRow(input_data[row], rows[row]);
+                                });
+  ORT_RETURN_IF_ERROR(status);
 
-    size_t utf8_chars = 0;
-    if (!utf8_validate(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
-                       utf8_chars)) {
-      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                    "Input string contains invalid utf8 chars: " + s);
-    }
+  return OutputTokens(ctx, rows, input_dims);
+}
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
-
-    StringPiece text(s);
-    const auto end_pos = s.length();
-    size_t start_pos = 0;
-    StringPiece submatch;
-
-    bool match = true;
-    do {
-      match = regex_->Match(text, start_pos, end_pos, anchor, &submatch, 1);
-      if (match) {
-        // Record  pos/len
-        assert(submatch.data() != nullptr);
-        size_t match_pos = submatch.data() - s.data();
-        assert(match_pos >= start_pos);
-        // Guard against empty match and make
-        // sure we make progress either way
-        auto token_len = submatch.length();
-        utf8_chars = 0;
-        if (!utf8_len(reinterpret_cast<const unsigned char*>(submatch.data()), token_len, utf8_chars)) {
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Match contains invalid utf8 chars: " + submatch.as_string());
-        }
-        if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
-          start_pos = match_pos + token_len;
-        } else {
-          size_t bytes = 0;
-          utf8_bytes(*submatch.data(), bytes);
-          start_pos = match_pos + bytes;
-        }
-      }
-    } while (match);
+Status Tokenizer::OutputTokens(OpKernelContext* ctx, const std::vector<std::vector<re2::StringPiece>>& rows,
+                               gsl::span<const int64_t> input_dims) const {
+  size_t max_tokens = 0;
+  for (const auto& row : rows) {
     max_tokens = std::max(max_tokens, row.size());
-    ++curr_input;
   }
 
-  // Check for empty output
   std::vector<int64_t> output_dims(input_dims.begin(), input_dims.end());
   // Check if we have no output due to either empty input
   // everything is a separator
@@ -419,43 +464,26 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
 
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->template MutableData<std::string>();
+  auto const input_data = ctx->Input<Tensor>(0)->template Data<std::string>();
 
-#ifdef _DEBUG
-  const size_t max_output_index = N * C * max_tokens;
-#endif
-  curr_input = input_data;
-  size_t output_index = 0;
-  for (const auto& row : tokens) {
-    assert(curr_input != last);
-#ifdef _DEBUG
-    size_t c_idx = output_index;
-#endif
+  // Every row owns max_tokens output strings, so the rows are written independently
+  return ParallelForRows(ctx->GetOperatorThreadPool(), input_data, rows.size(), 1.0, [&](size_t r) {
+    const auto& row = rows[r];
+    auto* output = output_data + r * max_tokens;
     if (mark_) {
-      (output_data + output_index)->assign(&start_text, 1);
-      ++output_index;
+      (output++)->assign(&start_text, 1);
     }
     // Output tokens for this row
     for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
-      ++output_index;
+      (output++)->assign(token.data(), token.size());
     }
     if (mark_) {
-      (output_data + output_index)->assign(&end_text, 1);
-      ++output_index;
+      (output++)->assign(&end_text, 1);
     }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      *(output_data + output_index) = pad_value_;
-      ++output_index;
-    }
-#ifdef _DEBUG
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-#endif
-    ++curr_input;
-  }
-
-  return Status::OK();
+    assert(row.size() + (static_cast<size_t>(mark_) * 2) <= max_tokens);
+    std::fill(output, output_data + (r + 1) * max_tokens, pad_value_);
+    return Status::OK();
+  });
 }
 
 Status Tokenizer::Compute(OpKernelContext* ctx) const {
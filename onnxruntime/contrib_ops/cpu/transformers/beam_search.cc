@@ -414,6 +414,11 @@ Status BeamSearchImpl<T>::Initialize() {
 
   ORT_RETURN_IF_ERROR(CheckInputs(context_));
 
+  if (gpt_subgraph_.past_present_share_buffer && IsCuda()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "GPT-2 subgraph with past_sequence_length input is only supported by the CPU operator");
+  }
+
   // This flag will be updated later when the scores output exists.
   parameters_->output_scores = false;
 
@@ -430,7 +435,7 @@ template <typename T>
 Status BeamSearchImpl<T>::CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths, OrtValue& expanded_input_ids, std::vector<OrtValue>& feeds, IAllocatorUniquePtr<char>& buffer) {
   const OrtValue* input_ids_value = context_.GetInputOrtValue(0);
   const Tensor& input_ids = input_ids_value->Get<Tensor>();
-  return gpt_subgraph_.CreateInitialFeeds(input_ids, implicit_inputs_, parameters_->num_beams, parameters_->pad_token_id, sequence_lengths, expanded_input_ids, feeds, create_inputs_func_, add_to_feeds_func_, buffer);
+  return gpt_subgraph_.CreateInitialFeeds(input_ids, implicit_inputs_, parameters_->num_beams, parameters_->pad_token_id, parameters_->max_length, sequence_lengths, expanded_input_ids, feeds, create_inputs_func_, add_to_feeds_func_, buffer);
 }
 
 template <typename T>
@@ -515,6 +520,12 @@ Status BeamSearchImpl<T>::Execute(const FeedsFetchesManager& feeds_fetches_manag
   // TODO: allocate fetches. use ping-pong buffers for past state.
   std::vector<OrtValue> fetches;
 
+  // When past and present share buffer, present_* outputs are written into the past_* inputs and the
+  // reordered past state of beams is gathered into these buffers.
+  const bool past_present_share_buffer = gpt_subgraph_.past_present_share_buffer;
+  const int num_layers = gpt_subgraph_.num_layers;
+  std::vector<OrtValue> scratch_past;
+
   // Initialize resources
   onnxruntime::OrtStlAllocator<HypothesisScore> hypothesis_score_allocator(cpu_allocator_);
   onnxruntime::OrtStlAllocator<BeamHypotheses> beam_hyps_allocator(cpu_allocator_);
@@ -587,6 +598,14 @@ Status BeamSearchImpl<T>::Execute(const FeedsFetchesManager& feeds_fetches_manag
     dumper->Print("***CurrentLength", cur_len, true);
 #endif
 
+    if (past_present_share_buffer) {
+      // Pre-allocated fetches let Attention append present state to the past state buffers in place.
+      fetches.resize(static_cast<size_t>(gpt_subgraph_.num_subgraph_outputs));
+      for (int i = 0; i < num_layers; ++i) {
+        fetches[static_cast<size_t>(1 + i)] = feeds[static_cast<size_t>(3 + i)];
+      }
+    }
+
     status = utils::ExecuteSubgraph(session_state_, feeds_fetches_manager, feeds, fetches, {},
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
 
@@ -607,10 +626,26 @@ Status BeamSearchImpl<T>::Execute(const FeedsFetchesManager& feeds_fetches_manag
 
     // Prepare inputs for next round of subgraph call.
     if (current_length < parameters_->max_length) {
-      ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
-                                      position_ids,
-                                      beam_next_tokens.as_span<const int32_t>(),
-                                      beam_indices.as_span<const int32_t>()));
+      if (past_present_share_buffer) {
+        // Only pass logits so that past state is not replaced, then reorder past state in place.
+        std::vector<OrtValue> last_outputs{fetches[0]};
+        ORT_RETURN_IF_ERROR(UpdateFeeds(last_outputs, feeds, current_length,
+                                        position_ids,
+                                        beam_next_tokens.as_span<const int32_t>(),
+                                        beam_indices.as_span<const int32_t>()));
+
+        BeamSearchCpuDeviceHelper::ReorderSharedPastState<T>(feeds, scratch_past, num_layers, current_length - 1,
+                                                             beam_indices.as_span<const int32_t>(),
+                                                             temp_space_allocator_);
+
+        OrtValue& past_sequence_length = feeds[static_cast<size_t>(3 + num_layers)];
+        *past_sequence_length.GetMutable<Tensor>()->MutableData<int32_t>() = current_length - 1;
+      } else {
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids,
+                                        beam_next_tokens.as_span<const int32_t>(),
+                                        beam_indices.as_span<const int32_t>()));
+      }
     }
     fetches.clear();
   }
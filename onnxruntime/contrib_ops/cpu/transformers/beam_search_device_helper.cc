@@ -442,6 +442,60 @@ Status UpdateFeeds(
   return Status::OK();
 }
 
+template <typename T>
+void ReorderSharedPastState(
+    std::vector<OrtValue>& next_inputs,
+    std::vector<OrtValue>& scratch_past,
+    int num_layers,
+    int past_sequence_length,
+    gsl::span<const int32_t> beam_indices,
+    AllocatorPtr allocator) {
+  bool is_identity = true;
+  for (gsl::index j = 0; j < beam_indices.length(); j++) {
+    if (beam_indices[j] != static_cast<int32_t>(j)) {
+      is_identity = false;
+      break;
+    }
+  }
+
+  // Every beam continues from itself, so the past state is already in the right place.
+  if (is_identity) {
+    return;
+  }
+
+  scratch_past.resize(static_cast<size_t>(num_layers));
+  for (int i = 0; i < num_layers; ++i) {
+    OrtValue& past = next_inputs[static_cast<size_t>(3 + i)];
+    const TensorShape& past_shape = past.Get<Tensor>().Shape();  // (2, batch_beam_size, num_heads, max_length, head_size)
+
+    OrtValue& scratch = scratch_past[static_cast<size_t>(i)];
+    if (!scratch.IsAllocated()) {
+      Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), past_shape, allocator, scratch);
+    }
+
+    const int64_t batch_beam_size = past_shape[1];
+    const int64_t num_heads = past_shape[2];
+    const int64_t chunk_size = past_shape[3] * past_shape[4];  // max_length * head_size
+    const int64_t valid_size = static_cast<int64_t>(past_sequence_length) * past_shape[4];
+    const int64_t block_size_per_beam = num_heads * chunk_size;
+    const int64_t past_key_size = batch_beam_size * block_size_per_beam;
+
+    const T* source = past.Get<Tensor>().Data<T>();
+    T* target = scratch.GetMutable<Tensor>()->MutableData<T>();
+    for (int64_t kv = 0; kv < 2; kv++) {
+      for (int64_t j = 0; j < batch_beam_size; j++) {
+        const T* src = source + kv * past_key_size + beam_indices[j] * block_size_per_beam;
+        T* dst = target + kv * past_key_size + j * block_size_per_beam;
+        for (int64_t h = 0; h < num_heads; h++) {
+          std::copy_n(src + h * chunk_size, valid_size, dst + h * chunk_size);
+        }
+      }
+    }
+
+    std::swap(past, scratch);
+  }
+}
+
 // Explicit template instantiations of functions
 template void InitBeamState<float>(
     transformers::IBeamSearchState<float>* beam_state,
@@ -486,6 +540,22 @@ template Status UpdateFeeds<float>(
     int num_beams,
     const transformers::IConsoleDumper* dumper);
 
+template void ReorderSharedPastState<float>(
+    std::vector<OrtValue>& next_inputs,
+    std::vector<OrtValue>& scratch_past,
+    int num_layers,
+    int past_sequence_length,
+    gsl::span<const int32_t> beam_indices,
+    AllocatorPtr allocator);
+
+template void ReorderSharedPastState<MLFloat16>(
+    std::vector<OrtValue>& next_inputs,
+    std::vector<OrtValue>& scratch_past,
+    int num_layers,
+    int past_sequence_length,
+    gsl::span<const int32_t> beam_indices,
+    AllocatorPtr allocator);
+
 }  // namespace BeamSearchCpuDeviceHelper
 }  // namespace contrib
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -176,6 +176,18 @@ Status UpdateFeeds(
     int num_beams,
     const transformers::IConsoleDumper* dumper);
 
+// Reorder past state buffers of shape (2, batch_beam_size, num_heads, max_length, head_size) by beam_indices.
+// Used when past and present share buffer, so only the first past_sequence_length tokens are valid and copied.
+// The reordered state is written to scratch_past, which is swapped with next_inputs[3 + layer] afterwards.
+template <typename T>
+void ReorderSharedPastState(
+    std::vector<OrtValue>& next_inputs,
+    std::vector<OrtValue>& scratch_past,
+    int num_layers,
+    int past_sequence_length,
+    gsl::span<const int32_t> beam_indices,
+    AllocatorPtr allocator);
+
 }  // namespace BeamSearchCpuDeviceHelper
 }  // namespace contrib
 }  // namespace onnxruntime
\ No newline at end of file
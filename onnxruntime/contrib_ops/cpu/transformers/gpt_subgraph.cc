@@ -21,17 +21,25 @@ GptSubgraph::GptSubgraph(
     const onnxruntime::Node& node_in,
     const std::string& attribute_name,
     const GraphViewer& subgraph_in)
-    : node(node_in), attribute(attribute_name), subgraph(subgraph_in), allocator_(nullptr), is_output_float16_(false) {
+    : node(node_in),
+      attribute(attribute_name),
+      subgraph(subgraph_in),
+      past_present_share_buffer(false),
+      allocator_(nullptr),
+      is_output_float16_(false) {
   num_implicit_inputs = static_cast<int>(node.ImplicitInputDefs().size());
 
   auto& subgraph_inputs = subgraph.GetInputs();
   auto& subgraph_outputs = subgraph.GetOutputs();
 
-  // inputs: input_ids, position_ids, attention_mask, past_0, past_1, ...
+  // inputs: input_ids, position_ids, attention_mask, past_0, past_1, ..., [past_sequence_length]
   // outputs: logits, present_0, present_1, ...
   num_subgraph_inputs = static_cast<int>(subgraph_inputs.size());
   num_subgraph_outputs = static_cast<int>(subgraph_outputs.size());
 
+  past_present_share_buffer = num_subgraph_inputs > 0 &&
+                              subgraph_inputs[num_subgraph_inputs - 1]->Name() == "past_sequence_length";
+
   // CheckSubgraph will verify inputs and outputs later.
   subgraph_input_names.reserve(num_subgraph_inputs);
   for (int i = 0; i < num_subgraph_inputs; ++i) {
@@ -49,8 +57,16 @@ Status GptSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_inputs,
   ORT_RETURN_IF(num_subgraph_outputs <= 1,
                 "Invalid GPT-2 subgraph: number of outputs shall be larger than 1 (Need past state in inputs and outputs).");
 
-  ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 2,
-                "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2");
+  if (past_present_share_buffer) {
+    ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 3,
+                  "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 3 when past_sequence_length is an input");
+
+    ORT_RETURN_IF(subgraph_inputs[num_subgraph_inputs - 1]->TypeAsProto()->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_INT32,
+                  "subgraph input past_sequence_length shall have int32 type");
+  } else {
+    ORT_RETURN_IF(num_subgraph_inputs != num_subgraph_outputs + 2,
+                  "Invalid GPT-2 subgraph: number of inputs shall be number of outputs plus 2");
+  }
 
   ORT_RETURN_IF(subgraph_inputs[0]->Name() != "input_ids", "subgraph input 0 shall be named as input_ids, got: ",
                 subgraph_inputs[0]->Name());
@@ -187,6 +203,7 @@ Status GptSubgraph::CreateInitialFeeds(
     const std::vector<const OrtValue*>& implicit_inputs,
     int num_beams,
     int pad_token_id,
+    int max_length,
     gsl::span<int32_t>& sequence_lengths,
     OrtValue& expanded_input_ids,
     std::vector<OrtValue>& feeds,
@@ -214,9 +231,9 @@ Status GptSubgraph::CreateInitialFeeds(
   auto default_allocator = provider->GetAllocator(0, OrtMemTypeDefault);
   allocator_ = default_allocator;
 
-  // Initialize empty past state
+  // Initialize empty past state. When past and present share buffer, the buffer has capacity of max_length tokens.
   auto past_type = IsOutputFloat16() ? DataTypeImpl::GetType<MLFloat16>() : DataTypeImpl::GetType<float>();
-  int64_t past_state_dims[] = {2, batch_size * num_beams, num_heads, 0, head_size};
+  int64_t past_state_dims[] = {2, batch_size * num_beams, num_heads, past_present_share_buffer ? max_length : 0, head_size};
   TensorShape past_shape(&past_state_dims[0], 5);
   OrtValue empty_past;
   Tensor::InitOrtValue(past_type, past_shape, default_allocator, empty_past);
@@ -231,8 +248,24 @@ Status GptSubgraph::CreateInitialFeeds(
   ORT_RETURN_IF_ERROR(add_to_feeds_func(provider, expanded_input_ids, expanded_position_ids, expanded_attention_mask, feeds, buffer));
 
   // The remaing inputs are past state.
-  for (int i = 3; i < num_subgraph_inputs; ++i) {
-    feeds.push_back(empty_past);
+  if (past_present_share_buffer) {
+    // Each layer needs its own buffer since present state is written to it in place.
+    for (int i = 0; i < num_layers; ++i) {
+      OrtValue past;
+      Tensor::InitOrtValue(past_type, past_shape, default_allocator, past);
+      feeds.push_back(past);
+    }
+
+    OrtValue past_sequence_length;
+    int64_t past_sequence_length_dims[] = {1};
+    TensorShape past_sequence_length_shape(&past_sequence_length_dims[0], 1);
+    Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), past_sequence_length_shape, cpu_alloactor, past_sequence_length);
+    *past_sequence_length.GetMutable<Tensor>()->MutableData<int32_t>() = 0;
+    feeds.push_back(past_sequence_length);
+  } else {
+    for (int i = 3; i < num_subgraph_inputs; ++i) {
+      feeds.push_back(empty_past);
+    }
   }
 
   // pass in implicit inputs
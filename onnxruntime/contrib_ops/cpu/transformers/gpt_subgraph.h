@@ -40,6 +40,11 @@ struct GptSubgraph {
   int vocab_size;
   int num_layers;
 
+  // Whether past and present state share buffer. It is enabled when the subgraph has an extra input named
+  // past_sequence_length after the past state inputs. Then past state buffers are allocated for max_length
+  // tokens, and the Attention nodes append present state in place.
+  bool past_present_share_buffer;
+
   // Setup exectuion
   Status Setup(const SessionState& session_state,
                const SessionState& subgraph_session_state);
@@ -50,6 +55,7 @@ struct GptSubgraph {
       const std::vector<const OrtValue*>& implicit_inputs,
       int num_beams,
       int pad_token_id,
+      int max_length,
       gsl::span<int32_t>& sequence_lengths,
       OrtValue& expanded_input_ids,
       std::vector<OrtValue>& feeds,
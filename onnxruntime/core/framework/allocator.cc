@@ -6,6 +6,7 @@
 #include "core/framework/allocatormgr.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/framework/utils.h"
+#include "core/platform/env.h"
 #include "core/session/ort_apis.h"
 #include <cstdlib>
 #include <sstream>
@@ -109,6 +110,12 @@ void* CPUAllocator::Alloc(size_t size) {
 void CPUAllocator::Free(void* p) {
   AllocatorDefaultFree(p);
 }
+
+void* NumaCPUAllocator::Alloc(size_t size) {
+  void* p = AllocatorDefaultAlloc(size);
+  Env::Default().SetPreferredNumaNode(p, size, numa_node_);
+  return p;
+}
 }  // namespace onnxruntime
 
 std::ostream& operator<<(std::ostream& out, const OrtMemoryInfo& info) { return (out << info.ToString()); }
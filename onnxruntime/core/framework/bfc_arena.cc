@@ -92,7 +92,7 @@ BFCArena::Chunk* BFCArena::ChunkFromHandle(ChunkHandle h) {
   return &(chunks_[h]);
 }
 
-Status BFCArena::Extend(size_t rounded_bytes) {
+Status BFCArena::Extend(size_t rounded_bytes, bool exact_size) {
   size_t available_bytes = memory_limit_ - static_cast<size_t>(stats_.total_allocated_bytes);
   // Rounds available_bytes down to the nearest multiple of kMinAllocationSize.
   available_bytes = (available_bytes / kMinAllocationSize) * kMinAllocationSize;
@@ -157,7 +157,7 @@ Status BFCArena::Extend(size_t rounded_bytes) {
     return extend_bytes;
   };
 
-  size_t bytes = get_extend_bytes(rounded_bytes);
+  size_t bytes = exact_size ? rounded_bytes : get_extend_bytes(rounded_bytes);
   // Try allocating.
   void* mem_addr = safe_alloc(bytes);
 
@@ -444,6 +444,15 @@ void BFCArena::Free(void* p) {
   }
 }
 
+Status BFCArena::ReserveRegion(size_t size) {
+  if (size == 0) {
+    return Status::OK();
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  return Extend(RoundedBytes(size), /*exact_size*/ true);
+}
+
 Status BFCArena::Shrink() {
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
@@ -83,6 +83,11 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Extends the arena by a single region of `size` bytes (rounded up to the allocation granularity)
+  // regardless of the extend strategy, so that allocations totaling up to `size` bytes can be served from it
+  // without further extensions.
+  Status ReserveRegion(size_t size);
+
   void* Reserve(size_t size) override;
 
   FencePtr CreateFence(const SessionState* session_state) override {
@@ -339,8 +344,9 @@ class BFCArena : public IAllocator {
   size_t RoundedBytes(size_t bytes);
 
   // Try to add a new memory region that can satisfy an allocation of
-  // 'rounded_bytes' bytes.
-  Status Extend(size_t rounded_bytes);
+  // 'rounded_bytes' bytes. The region is exactly 'rounded_bytes' if 'exact_size' is true,
+  // otherwise its size is determined by the extend strategy.
+  Status Extend(size_t rounded_bytes, bool exact_size = false);
 
   // Returns a pointer to an underlying allocated chunk of size
   // 'rounded_bytes'.
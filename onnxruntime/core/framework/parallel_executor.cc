@@ -19,11 +19,18 @@
 namespace onnxruntime {
 
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+    : terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
   const auto& graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer.MaxNodeIndex());
+  node_refs_ = std::make_unique<std::atomic<size_t>[]>(graph_viewer.MaxNodeIndex());
   for (auto& node : graph_viewer.Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()].store(node.GetInputEdgesCount(), std::memory_order_relaxed);
+  }
+
+  num_worker_slots_ = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(executor_pool_));
+  worker_queues_ = std::make_unique<WorkerQueue[]>(num_worker_slots_);
+  worker_slot_in_use_ = std::make_unique<std::atomic<bool>[]>(num_worker_slots_);
+  for (size_t i = 0; i < num_worker_slots_; ++i) {
+    worker_slot_in_use_[i].store(false, std::memory_order_relaxed);
   }
 }
 
@@ -40,24 +47,37 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
 
   root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                          fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
+  // the calling thread is the worker for slot 0. seed its queue with the root nodes and start a worker for each
+  // additional root node so independent branches begin in parallel.
+  worker_slot_in_use_[0].store(true, std::memory_order_relaxed);
+  active_workers_.store(1, std::memory_order_relaxed);
+
+  size_t num_root_nodes = 0;
   for (auto node_index : session_state.GetGraphViewer().GetRootNodes()) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
-    EnqueueNode(node_index, session_state, logger);
+    worker_queues_[0].nodes.push_back(node_index);
+    ++num_root_nodes;
+  }
+
+  for (size_t i = 1; i < num_root_nodes; ++i) {
+    TryStartWorker(session_state, logger);
   }
 
+  RunWorker(0, session_state, logger);
+  FinishWorker(0);
+
   // Wait for finish.
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
-    while (out_standings_ > 0) complete_cv_.wait(lock);
+    while (active_workers_.load() > 0) complete_cv_.wait(lock);
   }
 
   Status status = Status::OK();
 
+  // all workers have finished so errors_ is no longer modified
   if (!errors_.empty()) {
     if (errors_.size() == 1)
       status = errors_.front();
@@ -104,219 +124,273 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   return Status::OK();
 }
 
-Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
-                                      const SessionState& session_state,
-                                      const logging::Logger& logger) {
-  LOGS(logger, INFO) << "Begin execution";
 
+Status ParallelExecutor::RunNode(NodeIndex node_index,
+                                 const SessionState& session_state,
+                                 const logging::Logger& logger) {
   Status status = Status::OK();
 
-  size_t node_index = p_node_index;
-  bool keep_running = true;
+  if (terminate_flag_) {
+    LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+  }
+
   const auto& graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
-  // Avoid context switching if possible.
-  while (keep_running) {
-    // TODO: Convert RunNodeAsync return Status.
-    // to also handle exception propagation
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
-    }
-
-    const auto* p_op_kernel = session_state.GetKernel(node_index);
-    const auto& node = *graph_viewer.GetNode(node_index);
+  const auto* p_op_kernel = session_state.GetKernel(node_index);
+  const auto& node = *graph_viewer.GetNode(node_index);
 
-    // if a kernel has been added in the session state, it better be NON-null.
-    if (p_op_kernel == nullptr) {
-      ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
-    }
+  // if a kernel has been added in the session state, it better be NON-null.
+  if (p_op_kernel == nullptr) {
+    ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
+  }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+  OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
 
-    if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().Start();
-    }
-    // sync before compute
-    int queue_id = p_op_kernel->KernelDef().ExecQueueId();
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+  if (f_profiler_enabled) {
+    sync_time_begin = session_state.Profiler().Start();
+  }
+  // sync before compute
+  int queue_id = p_op_kernel->KernelDef().ExecQueueId();
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
         }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
       }
+    }
 
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
         }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
       }
+    }
 
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
-        }
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
       }
     }
+  }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
-      concurrency::ThreadPool::StartProfiling(session_state.GetThreadPool());
-      kernel_begin_time = session_state.Profiler().Start();
-    }
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_before",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+    concurrency::ThreadPool::StartProfiling(session_state.GetThreadPool());
+    kernel_begin_time = session_state.Profiler().Start();
+  }
 
-    // call compute on the kernel
-    VLOGS(logger, 1) << "Computing kernel: " << node.Name();
+  // call compute on the kernel
+  VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
-    // Execute the kernel.
-    ORT_TRY {
+  // Execute the kernel.
+  ORT_TRY {
 #ifdef ENABLE_TRAINING
-      if (p_op_kernel->KernelDef().AllocateInputsContiguously()) {
-        ORT_RETURN_IF_ERROR(utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context));
-      }
+    if (p_op_kernel->KernelDef().AllocateInputsContiguously()) {
+      ORT_RETURN_IF_ERROR(utils::VerifyInputTensorsAllocatedContiguously(&op_kernel_context));
+    }
 #endif
 
-      status = p_op_kernel->Compute(&op_kernel_context);
-    }
-    ORT_CATCH(const std::exception& ex) {
-      ORT_HANDLE_EXCEPTION([&]() {
-        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
-      });
-    }
+    status = p_op_kernel->Compute(&op_kernel_context);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
 
-    if (!status.IsOK()) {
-      std::ostringstream ss;
-      ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
-         << "' Status Message: " << status.ErrorMessage();
-      const auto msg_string = ss.str();
-      LOGS(logger, ERROR) << msg_string;
-      status = Status(status.Category(), status.Code(), msg_string);
-      break;
-    }
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()},
-                                                      {"provider", p_op_kernel->KernelDef().Provider()},
-                                                      {"thread_scheduling_stats", concurrency::ThreadPool::StopProfiling(session_state.GetThreadPool())}});
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_kernel_time",
+                                                   kernel_begin_time,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                    {"provider", p_op_kernel->KernelDef().Provider()},
+                                                    {"thread_scheduling_stats", concurrency::ThreadPool::StopProfiling(session_state.GetThreadPool())}});
 
-      sync_time_begin = session_state.Profiler().Start();
-    }
-    // sync after compute for outputs
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
+    sync_time_begin = session_state.Profiler().Start();
+  }
+  // sync after compute for outputs
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
       }
+    }
 
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
-        }
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
       }
+    }
 
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->AfterUsedAsOutput(queue_id);
-        }
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->AfterUsedAsOutput(queue_id);
       }
     }
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
-    }
+  }
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_after",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+  }
+
+  return status;
+}
 
-    //std::cout << "Run async node finish: " << p_node_index << std::endl;
+void ParallelExecutor::RunWorker(size_t slot, const SessionState& session_state, const logging::Logger& logger) {
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  auto& queue = worker_queues_[slot];
 
-    keep_running = false;
+  NodeIndex node_index;
+  while (PopNode(slot, node_index) || StealNode(slot, node_index)) {
+    // Avoid context switching if possible by running the first ready successor of each node on this thread.
+    bool keep_running = true;
+    while (keep_running) {
+      keep_running = false;
 
-    // Checking which output nodes ready for running.
-    {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
+      // if there are errors there's no point running more nodes. keep popping to drain the queues.
+      if (has_errors_.load(std::memory_order_relaxed)) {
+        break;
+      }
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
+      Status status;
+      ORT_TRY {
+        status = RunNode(node_index, session_state, logger);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          const auto* node = graph_viewer.GetNode(node_index);
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running ", node->OpType(),
+                                   " node '", node->Name(), "'. ", ex.what());
+        });
+      }
+      ORT_CATCH(...) {
+        // catch node processing failure exceptions here to prevent app crash.
+        const auto* node = graph_viewer.GetNode(node_index);
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running ", node->OpType(),
+                                 " node '", node->Name(), "'. Unknown exception was caught by catch-all handler.");
+      }
+
+      if (!status.IsOK()) {
+        RecordError(status);
+        break;
+      }
+
+      // Checking which output nodes are ready for running.
+      const auto& node = *graph_viewer.GetNode(node_index);
+      size_t num_queued = 0;
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+        auto idx = it->GetNode().Index();
+        // acq_rel so that the outputs written by every producer of idx are visible to whoever runs it
+        if (node_refs_[idx].fetch_sub(1, std::memory_order_acq_rel) == 1) {
           if (!keep_running) {
             node_index = idx;
             keep_running = true;
           } else {
-            EnqueueNode(idx, session_state, logger);
+            std::lock_guard<OrtMutex> lock(queue.mutex);
+            queue.nodes.push_back(idx);
+            ++num_queued;
           }
         }
+      }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+      // wake up idle threads to steal the nodes we can't run inline
+      for (size_t i = 0; i < num_queued; ++i) {
+        TryStartWorker(session_state, logger);
       }
     }
   }
-
-  return status;
 }
 
-void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
-
-    out_standings_++;
+bool ParallelExecutor::PopNode(size_t slot, NodeIndex& node_index) {
+  auto& queue = worker_queues_[slot];
+  std::lock_guard<OrtMutex> lock(queue.mutex);
+  if (queue.nodes.empty()) {
+    return false;
   }
 
-  onnxruntime::concurrency::ThreadPool::Schedule(executor_pool_, [this, p_node_index, &session_state, &logger]() {
-    auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
-      const auto* node = session_state.GetGraphViewer().GetNode(p_node_index);
-
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
-                             " node '", node->Name(), "'. ",
-                             ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
-    };
+  node_index = queue.nodes.back();
+  queue.nodes.pop_back();
+  return true;
+}
 
-    Status status;
-    ORT_TRY {
-      status = ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
+bool ParallelExecutor::StealNode(size_t slot, NodeIndex& node_index) {
+  for (size_t i = 1; i < num_worker_slots_; ++i) {
+    auto& queue = worker_queues_[(slot + i) % num_worker_slots_];
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    if (!queue.nodes.empty()) {
+      // take the oldest node, which is the one least likely to have its inputs in the owner's cache
+      node_index = queue.nodes.front();
+      queue.nodes.pop_front();
+      return true;
     }
-    ORT_CATCH(const std::exception& ex) {
-      ORT_HANDLE_EXCEPTION([&]() {
-        status = create_exception_message(&ex);
+  }
+
+  return false;
+}
+
+void ParallelExecutor::TryStartWorker(const SessionState& session_state, const logging::Logger& logger) {
+  // slot 0 belongs to the thread calling Execute so is never handed to the executor pool
+  for (size_t slot = 1; slot < num_worker_slots_; ++slot) {
+    bool expected = false;
+    if (!worker_slot_in_use_[slot].load(std::memory_order_relaxed) &&
+        worker_slot_in_use_[slot].compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      // the caller is an active worker, so active_workers_ can't reach zero before this increment
+      ++active_workers_;
+
+      onnxruntime::concurrency::ThreadPool::Schedule(executor_pool_, [this, slot, &session_state, &logger]() {
+        RunWorker(slot, session_state, logger);
+        FinishWorker(slot);
       });
+
+      return;
     }
-    ORT_CATCH(...) {
-      // catch node processing failure exceptions here to prevent app crash.
-      status = create_exception_message(nullptr);
-    }
+  }
+}
+
+void ParallelExecutor::FinishWorker(size_t slot) {
+  worker_slot_in_use_[slot].store(false, std::memory_order_release);
+
+  // decrement under the lock so Execute can't observe zero, return and destroy this instance before notify_all
+  std::lock_guard<OrtMutex> lock(complete_mutex_);
+  if (--active_workers_ == 0) {
+    complete_cv_.notify_all();
+  }
+}
 
-    FinishNodeRun(status);
-  });
+void ParallelExecutor::RecordError(const Status& status) {
+  std::lock_guard<OrtMutex> lock(errors_mutex_);
+  errors_.push_back(status);
+  has_errors_.store(true, std::memory_order_relaxed);
 }
 }  // namespace onnxruntime
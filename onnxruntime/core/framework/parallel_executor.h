@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -31,33 +34,47 @@ class ParallelExecutor : public IExecutor {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelExecutor);
 
-  Status RunNodeAsync(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+  // Nodes that are ready to run. The owning worker pushes and pops at the back, other workers steal from the front.
+  struct WorkerQueue {
+    OrtMutex mutex;
+    std::deque<NodeIndex> nodes;
+  };
 
-  void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+  // Execute a single node. Returns the status of the kernel's Compute.
+  Status RunNode(NodeIndex node_index, const SessionState& session_state, const logging::Logger& logger);
 
-  void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
-      std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
-    }
+  // Worker loop for `slot`. Runs nodes from the slot's queue, following the first ready successor of each node
+  // inline, and steals from the other queues when its own is empty. Returns when no work can be found.
+  void RunWorker(size_t slot, const SessionState& session_state, const logging::Logger& logger);
 
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
-      complete_cv_.notify_all();
-    }
-  }
+  // Claim a free worker slot and schedule a worker for it on the executor pool, if one is available.
+  void TryStartWorker(const SessionState& session_state, const logging::Logger& logger);
+
+  // Release `slot` once its worker has finished. Wakes up Execute when the last worker finishes.
+  void FinishWorker(size_t slot);
+
+  bool PopNode(size_t slot, NodeIndex& node_index);
+  bool StealNode(size_t slot, NodeIndex& node_index);
+
+  void RecordError(const Status& status);
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+
+  // number of inputs edges of each node that are yet to be satisfied. a node is ready when it reaches 0.
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+
+  // one slot per degree of parallelism of the executor pool. slot 0 is used by the thread calling Execute.
+  size_t num_worker_slots_;
+  std::unique_ptr<WorkerQueue[]> worker_queues_;
+  std::unique_ptr<std::atomic<bool>[]> worker_slot_in_use_;
+
+  std::atomic<int> active_workers_{0};
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+
+  std::atomic<bool> has_errors_{false};
+  OrtMutex errors_mutex_;
+  std::vector<Status> errors_;  // protected by errors_mutex_
 
   const bool& terminate_flag_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
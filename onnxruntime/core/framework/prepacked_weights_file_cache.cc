@@ -0,0 +1,370 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+// File layout (native byte order, the file is only valid on the machine type that wrote it):
+//   char[8]  magic
+//   uint32   format version
+//   uint32   length of the platform string, followed by the platform string
+//   uint64   number of entries
+//   per entry:
+//     uint32   length of the key, followed by the key
+//     uint32   number of buffers
+//     per buffer: uint64 offset from the start of the file (kNullBufferOffset for a null buffer), uint64 size
+//   buffer data, each buffer aligned to kBufferAlignment
+namespace {
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', 'C', '\0'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr size_t kBufferAlignment = 64;
+constexpr uint64_t kNullBufferOffset = ~uint64_t(0);
+
+// The pre-packed layout depends on the MLAS kernels selected for the CPU and may change between releases.
+const std::string& PlatformSignature() {
+  static const std::string signature = []() {
+    const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+    std::ostringstream ss;
+    ss << ORT_VERSION << ";ptr" << sizeof(void*)
+       << ";avx" << cpuid_info.HasAVX() << cpuid_info.HasAVX2() << cpuid_info.HasAVX512f()
+       << cpuid_info.HasAVX512Skylake() << ";f16c" << cpuid_info.HasF16C()
+       << ";sse" << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1()
+       << ";neondot" << cpuid_info.HasArmNeonDot();
+    return ss.str();
+  }();
+
+  return signature;
+}
+
+void HashBytes(const void* data, size_t size, uint32_t (&hash)[4]) {
+  // MurmurHash3 takes an int length so hash large buffers in chunks, chaining the hash through the seed
+  constexpr size_t kMaxChunk = size_t(1) << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk = std::min(size, kMaxChunk);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash[0], &hash);
+    bytes += chunk;
+    size -= chunk;
+  } while (size > 0);
+}
+
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (size_ - pos_ < sizeof(T)) {
+      return false;
+    }
+
+    memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t length;
+    if (!Read(length) || size_ - pos_ < length) {
+      return false;
+    }
+
+    value.assign(data_ + pos_, length);
+    pos_ += length;
+    return true;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+// <file_path>.<pid>.<random>.tmp
+PathString TempFilePath(const PathString& file_path) {
+  std::random_device random_device;
+  std::ostringstream suffix;
+  suffix << '.' << Env::Default().GetSelfPid() << '.' << std::hex << random_device() << random_device() << ".tmp";
+  return file_path + ToPathString(suffix.str());
+}
+
+void RemoveFile(const PathString& path) {
+#ifdef _WIN32
+  _wremove(path.c_str());
+#else
+  std::remove(path.c_str());
+#endif
+}
+
+template <typename T>
+void Write(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::string& out, const std::string& value) {
+  Write(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+}  // namespace
+
+Status PrepackedWeightsFileCache::Load(const Env& env, const logging::Logger& logger) {
+  size_t file_length = 0;
+  if (!env.GetFileLength(file_path_.c_str(), file_length).IsOK() || file_length == 0) {
+    LOGS(logger, INFO) << "Pre-packed weights cache file " << ToUTF8String(file_path_)
+                       << " doesn't exist. It will be created.";
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(file_path_.c_str(), 0, file_length, mapped_file_));
+
+  auto status = ParseFile(file_length);
+  if (!status.IsOK()) {
+    LOGS(logger, WARNING) << "Ignoring pre-packed weights cache file " << ToUTF8String(file_path_) << ": "
+                          << status.ErrorMessage();
+    loaded_entries_.clear();
+    mapped_file_.reset();
+  }
+
+  return Status::OK();
+}
+
+Status PrepackedWeightsFileCache::ParseFile(size_t file_length) {
+  const char* data = mapped_file_.get();
+  Reader reader(data, file_length);
+
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  ORT_RETURN_IF_NOT(reader.Read(magic) && memcmp(magic, kMagic, sizeof(kMagic)) == 0,
+                    "Not a pre-packed weights cache file.");
+  ORT_RETURN_IF_NOT(reader.Read(version) && version == kFormatVersion, "Unsupported format version.");
+
+  std::string platform;
+  ORT_RETURN_IF_NOT(reader.ReadString(platform), "Truncated file.");
+  ORT_RETURN_IF_NOT(platform == PlatformSignature(), "The file was created for a different platform (", platform,
+                    ") than the current one (", PlatformSignature(), ").");
+
+  uint64_t num_entries;
+  ORT_RETURN_IF_NOT(reader.Read(num_entries), "Truncated file.");
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    std::string key;
+    uint32_t num_buffers;
+    ORT_RETURN_IF_NOT(reader.ReadString(key) && reader.Read(num_buffers), "Truncated file.");
+
+    std::vector<Buffer> buffers;
+    buffers.reserve(num_buffers);
+    for (uint32_t b = 0; b < num_buffers; ++b) {
+      uint64_t offset, size;
+      ORT_RETURN_IF_NOT(reader.Read(offset) && reader.Read(size), "Truncated file.");
+      if (offset == kNullBufferOffset) {
+        buffers.push_back({nullptr, static_cast<size_t>(size)});
+      } else {
+        ORT_RETURN_IF_NOT(offset <= file_length && size <= file_length - offset,
+                          "Buffer of entry ", key, " is outside of the file.");
+        buffers.push_back({data + offset, static_cast<size_t>(size)});
+      }
+    }
+
+    loaded_entries_.emplace(std::move(key), std::move(buffers));
+  }
+
+  return Status::OK();
+}
+
+std::string PrepackedWeightsFileCache::GenerateKey(const Node& node, int input_idx, const Tensor& tensor) {
+  if (tensor.IsDataTypeString()) {
+    return {};
+  }
+
+  std::ostringstream key;
+  key << node.Domain() << ':' << node.OpType() << ':' << node.SinceVersion() << ':' << input_idx;
+
+  // the kernel selected, and how it packs, can depend on the type of every input
+  for (const auto* input_def : node.InputDefs()) {
+    key << ':' << (input_def->Exists() && input_def->Type() ? *input_def->Type() : "");
+  }
+
+  key << ':' << tensor.Shape().ToString();
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  std::vector<std::string> attr_names;
+  for (const auto& attr : node.GetAttributes()) {
+    if (attr.second.type() != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH &&
+        attr.second.type() != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPHS) {
+      attr_names.push_back(attr.first);
+    }
+  }
+
+  std::sort(attr_names.begin(), attr_names.end());
+  for (const auto& name : attr_names) {
+    const std::string serialized = node.GetAttributes().at(name).SerializeAsString();
+    HashBytes(serialized.data(), serialized.size(), hash);
+  }
+
+  key << ':' << std::hex << std::setfill('0');
+  for (int i = 0; i < 2; ++i) {
+    key << std::setw(8) << hash[i];
+  }
+
+  hash[0] = hash[1] = hash[2] = hash[3] = 0;
+  HashBytes(tensor.DataRaw(), tensor.SizeInBytes(), hash);
+  key << ':';
+  for (int i = 0; i < 4; ++i) {
+    key << std::setw(8) << hash[i];
+  }
+
+  return key.str();
+}
+
+const std::vector<PrepackedWeightsFileCache::Buffer>* PrepackedWeightsFileCache::Find(const std::string& key) const {
+  auto entry = loaded_entries_.find(key);
+  return entry != loaded_entries_.end() ? &entry->second : nullptr;
+}
+
+void PrepackedWeightsFileCache::MarkUsed(const std::string& key) {
+  used_keys_.push_back(key);
+}
+
+void PrepackedWeightsFileCache::Add(const std::string& key, PrePackedWeights&& weights) {
+  std::vector<Buffer> buffers;
+  for (size_t i = 0, end = weights.buffers_.size(); i < end; ++i) {
+    buffers.push_back({weights.buffers_[i].get(), weights.buffer_sizes_[i]});
+  }
+
+  added_entries_[key] = std::move(buffers);
+  Hold(std::move(weights));
+}
+
+const PrePackedWeights& PrepackedWeightsFileCache::Hold(PrePackedWeights&& weights) {
+  packed_weights_.push_back(std::move(weights));
+  return packed_weights_.back();
+}
+
+Status PrepackedWeightsFileCache::SaveIfModified(const logging::Logger& logger) const {
+  if (added_entries_.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<std::pair<const std::string*, const std::vector<Buffer>*>> entries;
+  for (const auto& key : used_keys_) {
+    auto entry = loaded_entries_.find(key);
+    if (entry != loaded_entries_.end() && added_entries_.count(key) == 0) {
+      entries.emplace_back(&entry->first, &entry->second);
+    }
+  }
+
+  for (const auto& entry : added_entries_) {
+    entries.emplace_back(&entry.first, &entry.second);
+  }
+
+  // the same weight may be used by several nodes
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return *a.first < *b.first; });
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [](const auto& a, const auto& b) { return *a.first == *b.first; }),
+                entries.end());
+
+  // the index is written first so its size is needed to know where the buffer data starts
+  size_t index_size = sizeof(kMagic) + sizeof(uint32_t) + sizeof(uint32_t) + PlatformSignature().size() +
+                      sizeof(uint64_t);
+  for (const auto& entry : entries) {
+    index_size += sizeof(uint32_t) + entry.first->size() + sizeof(uint32_t) +
+                  entry.second->size() * 2 * sizeof(uint64_t);
+  }
+
+  auto align = [](uint64_t offset) { return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment; };
+
+  std::string index;
+  index.reserve(index_size);
+  index.append(kMagic, sizeof(kMagic));
+  Write(index, kFormatVersion);
+  WriteString(index, PlatformSignature());
+  Write(index, static_cast<uint64_t>(entries.size()));
+
+  uint64_t offset = align(index_size);
+  for (const auto& entry : entries) {
+    WriteString(index, *entry.first);
+    Write(index, static_cast<uint32_t>(entry.second->size()));
+    for (const auto& buffer : *entry.second) {
+      if (buffer.data == nullptr) {
+        Write(index, kNullBufferOffset);
+      } else {
+        Write(index, offset);
+        offset = align(offset + buffer.size);
+      }
+
+      Write(index, static_cast<uint64_t>(buffer.size));
+    }
+  }
+
+  ORT_RETURN_IF_NOT(index.size() == index_size, "Unexpected pre-packed weights cache index size.");
+
+  // write to a temporary file and rename it as the current file may be mapped by this or another process.
+  // the name is unique so that sessions created at the same time by several processes don't write the same file.
+  const PathString temp_path = TempFilePath(file_path_);
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(out, "Failed to open ", ToUTF8String(temp_path), " for writing.");
+
+    const char padding[kBufferAlignment] = {};
+    out.write(index.data(), index.size());
+    uint64_t written = index.size();
+    for (const auto& entry : entries) {
+      for (const auto& buffer : *entry.second) {
+        if (buffer.data != nullptr) {
+          out.write(padding, align(written) - written);
+          out.write(static_cast<const char*>(buffer.data), buffer.size);
+          written = align(written) + buffer.size;
+        }
+      }
+    }
+
+    if (!out.flush()) {
+      out.close();
+      RemoveFile(temp_path);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", ToUTF8String(temp_path));
+    }
+  }
+
+#ifdef _WIN32
+  // a file can't be replaced on Windows while it is mapped, which it is if this or another session loaded it.
+  // the file is left as is and a later session, created once those are gone, will update it.
+  if (_wremove(file_path_.c_str()) != 0 && errno != ENOENT) {
+    const int error = errno;
+    RemoveFile(temp_path);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace ", ToUTF8String(file_path_),
+                           ". It may be in use by another session. errno: ", error);
+  }
+
+  const bool renamed = _wrename(temp_path.c_str(), file_path_.c_str()) == 0;
+#else
+  const bool renamed = std::rename(temp_path.c_str(), file_path_.c_str()) == 0;
+#endif
+  if (!renamed) {
+    RemoveFile(temp_path);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace ", ToUTF8String(file_path_));
+  }
+
+  LOGS(logger, INFO) << "Wrote " << entries.size() << " pre-packed weights to " << ToUTF8String(file_path_);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+/**
+ * Cache of pre-packed weights that is persisted to a file so that later processes can skip PrePack().
+ *
+ * The file is memory mapped when loading and the cached buffers are used in place, so they are shared with the
+ * page cache and any other session that maps the same file.
+ *
+ * Entries are keyed by everything that determines the contents of the pre-packed buffers: the kernel (op and
+ * input types), the node attributes, the input index, the weight's shape and data and the CPU features the packing
+ * was done for. A stale or mismatched file therefore results in cache misses rather than wrong results.
+ */
+class PrepackedWeightsFileCache final {
+ public:
+  struct Buffer {
+    const void* data;
+    size_t size;
+  };
+
+  explicit PrepackedWeightsFileCache(PathString file_path) : file_path_(std::move(file_path)) {}
+
+  // Maps the cache file into memory. A missing or incompatible file is not an error, and leaves the cache empty.
+  Status Load(const Env& env, const logging::Logger& logger);
+
+  // Writes the entries used by the session back to the file if any of them were not in the loaded file.
+  Status SaveIfModified(const logging::Logger& logger) const;
+
+  // Generates the key for the pre-packed buffers of `tensor` when used as input `input_idx` of `node`.
+  static std::string GenerateKey(const Node& node, int input_idx, const Tensor& tensor);
+
+  // Returns the buffers for the key or nullptr if the file doesn't have them.
+  // The buffers are valid for the lifetime of this instance.
+  const std::vector<Buffer>* Find(const std::string& key) const;
+
+  // Records that a loaded entry was used by the session so that it is kept when the file is rewritten.
+  void MarkUsed(const std::string& key);
+
+  // Adds buffers that were packed by this session to be written to the file. The cache takes ownership of the
+  // buffers and they are valid for the lifetime of this instance.
+  void Add(const std::string& key, PrePackedWeights&& weights);
+
+  // Keeps buffers packed by this session that are not written to the file because the kernel can't use persisted
+  // buffers. They are valid for the lifetime of this instance.
+  const PrePackedWeights& Hold(PrePackedWeights&& weights);
+
+  const PathString& FilePath() const { return file_path_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+
+  Status ParseFile(size_t file_length);
+
+  const PathString file_path_;
+
+  Env::MappedMemoryPtr mapped_file_;
+  std::unordered_map<std::string, std::vector<Buffer>> loaded_entries_;
+
+  // buffers packed by this session. a list so references returned by Hold() stay valid.
+  std::list<PrePackedWeights> packed_weights_;
+  std::unordered_map<std::string, std::vector<Buffer>> added_entries_;
+
+  // keys of the loaded entries used by this session
+  std::vector<std::string> used_keys_;
+};
+
+}  // namespace onnxruntime
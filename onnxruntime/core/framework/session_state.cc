@@ -286,6 +286,63 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+// Uses the pre-packed buffers from the file cache if the kernel accepts them. Otherwise calls PrePack() and adds
+// the pre-packed buffers to the file cache, if the kernel can use them from there in later sessions.
+static Status PrePackWithFileCache(PrepackedWeightsFileCache& file_cache, const Node& node, OpKernel& kernel,
+                                   const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                   /*out*/ bool& is_packed, /*out*/ bool& used_persisted_buffers) {
+  is_packed = false;
+  used_persisted_buffers = false;
+
+  const std::string key = PrepackedWeightsFileCache::GenerateKey(node, input_idx, tensor);
+  if (key.empty()) {
+    return kernel.PrePack(tensor, input_idx, alloc, is_packed, nullptr);
+  }
+
+  const auto* cached_buffers = file_cache.Find(key);
+  if (cached_buffers != nullptr) {
+    std::vector<BufferUniquePtr> persisted_buffers;
+    persisted_buffers.reserve(cached_buffers->size());
+    for (const auto& buffer : *cached_buffers) {
+      // the buffers are owned by the file cache. kernels don't write to pre-packed buffers.
+      persisted_buffers.emplace_back(const_cast<void*>(buffer.data), BufferDeleter(nullptr));
+    }
+
+    ORT_RETURN_IF_ERROR(kernel.UsePersistedPrePackedBuffers(tensor, input_idx, persisted_buffers,
+                                                            used_persisted_buffers));
+    if (used_persisted_buffers) {
+      file_cache.MarkUsed(key);
+      is_packed = true;
+      return Status::OK();
+    }
+  }
+
+  PrePackedWeights weights;
+  ORT_RETURN_IF_ERROR(kernel.PrePack(tensor, input_idx, alloc, is_packed, &weights));
+
+  // kernels that don't fill in the buffers keep the pre-packed data themselves and aren't cached
+  if (is_packed && !weights.buffers_.empty()) {
+    // the new buffers are offered as persisted ones so only the kernels that can use them from the file get them
+    // written to it. otherwise every session of a model with such a kernel would rewrite the file.
+    std::vector<BufferUniquePtr> packed_buffers;
+    packed_buffers.reserve(weights.buffers_.size());
+    for (const auto& buffer : weights.buffers_) {
+      packed_buffers.emplace_back(buffer.get(), BufferDeleter(nullptr));
+    }
+
+    bool persistable = false;
+    ORT_RETURN_IF_ERROR(kernel.UsePersistedPrePackedBuffers(tensor, input_idx, packed_buffers, persistable));
+    if (persistable) {
+      file_cache.Add(key, std::move(weights));
+    } else {
+      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(kernel, input_idx, file_cache.Hold(std::move(weights)),
+                                                          node.Name()));
+    }
+  }
+
+  return Status::OK();
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -298,7 +355,13 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(std::unordered_map<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  // subgraphs share the file cache of the main graph
+  PrepackedWeightsFileCache* file_cache = nullptr;
+  for (const SessionState* st = this; st != nullptr; st = st->parent_) {
+    file_cache = st->prepacked_weights_file_cache_.get();
+  }
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map, file_cache](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -378,6 +441,15 @@ Status SessionState::PrepackConstantInitializedTensors(std::unordered_map<std::s
                     }
                   }
 
+                } else if (file_cache != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
+                  bool used_persisted_buffers = false;
+                  ORT_RETURN_IF_ERROR(PrePackWithFileCache(*file_cache, node, *kernel, const_initialized_tensor,
+                                                           input_idx, session_cpu_alloc, is_packed,
+                                                           used_persisted_buffers));
+                  if (used_persisted_buffers) {
+                    ++used_persisted_pre_packed_weights_counter_;
+                  }
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(0, OrtMemType::OrtMemTypeDefault);
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -433,7 +505,6 @@ static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tenso
   return key;
 }
 
-#ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
                         const std::map<std::string, TensorShape>& feeds,
@@ -503,6 +574,7 @@ Status TryResolveShape(
   return Status::OK();
 }
 
+#ifdef ENABLE_TRAINING
 void TryCalculateSizeFromResolvedShape(int ml_value_idx, std::unordered_map<int, TensorShape>& resolved_shapes, size_t& size) {
   size = 0;
   auto shape = resolved_shapes.find(ml_value_idx);
@@ -512,9 +584,11 @@ void TryCalculateSizeFromResolvedShape(int ml_value_idx, std::unordered_map<int,
       size *= dim;
   }
 }
+#endif
 
 }  // namespace
 
+#ifdef ENABLE_TRAINING
 // If this function fails NO memory planning will take place, hence lets ONLY FAIL and stop training where warranted, example SIZE overflow.
 Status SessionState::GeneratePatternGroupCache(const gsl::span<const OrtValue>& tensor_inputs,
                                                const std::vector<int>& feed_mlvalue_idxs,
@@ -652,6 +726,65 @@ Status SessionState::GeneratePatternGroupCache(const gsl::span<const OrtValue>&
 }
 #endif
 
+Status SessionState::ComputePeakActivationMemory(const std::map<std::string, TensorShape>& input_shapes,
+                                                 std::map<OrtMemoryInfo, size_t>& peak_sizes) const {
+  std::unordered_map<std::string, int64_t> dim_params;
+  ORT_RETURN_IF_ERROR(ResolveDimParams(*graph_viewer_, input_shapes, dim_params));
+
+  const auto* exe_plan = GetExecutionPlan();
+  ORT_RETURN_IF(exe_plan == nullptr, "Execution plan has not been created.");
+  OrtValuePatternPlanner mem_planner(*exe_plan);
+
+  // replay the allocations and frees of the execution plan
+  const auto& node_index_info = GetNodeIndexInfo();
+  for (const auto& node_plan : exe_plan->execution_plan) {
+    int node_index = node_index_info.GetNodeOffset(node_plan.node_index);
+    const auto* node = graph_viewer_->GetNode(node_plan.node_index);
+    int output_start = node_index + static_cast<int>(node->InputDefs().size()) +
+                       static_cast<int>(node->ImplicitInputDefs().size());
+
+    for (int i = 0, end = static_cast<int>(node->OutputDefs().size()); i < end; ++i) {
+      const auto ml_value_idx = node_index_info.GetMLValueIndex(output_start + i);
+      if (ml_value_idx == NodeIndexInfo::kInvalidEntry)
+        continue;
+
+      const auto& value_plan = exe_plan->allocation_plan[ml_value_idx];
+      if (value_plan.alloc_kind != AllocKind::kAllocate || !value_plan.value_type->IsTensorType())
+        continue;
+
+      const auto* ml_data_type = static_cast<const TensorTypeBase*>(value_plan.value_type)->GetElementType();
+      if (ml_data_type == DataTypeImpl::GetType<std::string>())
+        continue;
+
+      size_t num_elements = 0;
+      TensorShapeVector resolved_shape;
+      if (!TryResolveShape(node->OutputDefs()[i], dim_params, num_elements, resolved_shape).IsOK() ||
+          num_elements == 0) {
+        continue;
+      }
+
+      size_t size = 0;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(num_elements, ml_data_type->Size(), &size)) {
+        return Status(ONNXRUNTIME, FAIL, "Size overflow");
+      }
+
+      ORT_RETURN_IF_ERROR(mem_planner.TraceAllocation(ml_value_idx, size));
+    }
+
+    for (int index = node_plan.free_from_index; index <= node_plan.free_to_index; ++index) {
+      ORT_RETURN_IF_ERROR(mem_planner.TraceFree(exe_plan->to_be_freed[index]));
+    }
+  }
+
+  MemoryPatternGroup mem_patterns;
+  ORT_RETURN_IF_ERROR(mem_planner.GeneratePatterns(&mem_patterns));
+  for (size_t i = 0; i < mem_patterns.locations.size(); ++i) {
+    peak_sizes[mem_patterns.locations[i]] = mem_patterns.patterns[i].PeakSize();
+  }
+
+  return Status::OK();
+}
+
 const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const gsl::span<const OrtValue>& tensor_inputs,
                                                               const std::vector<int>& feed_mlvalue_idxs,
                                                               std::unordered_map<int, TensorShape>& inferred_shapes) const {
@@ -1201,10 +1334,31 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
 #endif
   }
 
+#ifndef ENABLE_TRAINING
+  const std::string prepacked_weights_cache_file =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsCacheFile, "");
+  if (!prepacked_weights_cache_file.empty() &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") != "1") {
+    prepacked_weights_file_cache_ =
+        std::make_unique<PrepackedWeightsFileCache>(ToPathString(prepacked_weights_cache_file));
+    ORT_RETURN_IF_ERROR(prepacked_weights_file_cache_->Load(Env::Default(), logger_));
+  }
+#endif
+
   std::unordered_map<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, session_options,
-                                  remove_initializers, constant_initializers_use_count);
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, session_options,
+                                               remove_initializers, constant_initializers_use_count));
+
+  if (prepacked_weights_file_cache_) {
+    // failing to update the file only costs the next session its start up time
+    auto status = prepacked_weights_file_cache_->SaveIfModified(logger_);
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to write the pre-packed weights cache file: " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
 }
 
 static Status Index(const OrtValueNameIdxMap& ort_value_name_idx_map,
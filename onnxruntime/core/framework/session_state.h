@@ -21,6 +21,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
@@ -220,6 +221,14 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const gsl::span<const OrtValue>& tensor_inputs,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Compute the peak memory usage per location of the activations planned for the given graph input shapes.
+  Uses the same planner as the memory patterns. Activations whose shape cannot be resolved from the input shapes
+  are allocated at runtime and not included.
+  */
+  Status ComputePeakActivationMemory(const std::map<std::string, TensorShape>& input_shapes,
+                                     std::map<OrtMemoryInfo, size_t>& peak_sizes) const;
+
   bool GetUseDeterministicCompute() const { return use_deterministic_compute_; }
 
   /**
@@ -318,6 +327,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedPersistedPrePackedWeightCounter() const {
+    return used_persisted_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -498,6 +511,9 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Pre-packed weights persisted to a file. Only set on the main graph's SessionState, subgraphs use their root's.
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
 #if !defined(ORT_MINIMAL_BUILD)
 #ifndef DISABLE_ABSEIL
   InlinedHashMap<InlinedVector<int>, InlinedHashSet<NodeIndex>> to_be_executed_nodes_;
@@ -527,6 +543,9 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight from the file cache was used by the session state
+  size_t used_persisted_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
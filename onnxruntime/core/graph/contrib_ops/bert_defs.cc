@@ -72,6 +72,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Attention, 1,
                                       "Hidden layer sizes of Q, K, V paths in Attention",
                                       AttributeProto::INTS,
                                       OPTIONAL_VALUE)
+                                .Attr("past_present_share_buffer",
+                                      "Whether past and present state share a buffer with capacity for max_sequence_length tokens. "
+                                      "When it is 1, past and present have shape (2, batch_size, num_heads, max_sequence_length, head_size), "
+                                      "the present state is appended in place after past_sequence_length tokens, "
+                                      "and input past_sequence_length is required. Default value is 0.",
+                                      AttributeProto::INT,
+                                      static_cast<int64_t>(0))
                                 .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, input_hidden_size)", "T")
                                 .Input(1, "weight", "2D input tensor with shape (input_hidden_size, 3 * hidden_size), where hidden_size = num_heads * head_size", "T")
                                 .Input(2, "bias", "1D input tensor with shape (3 * hidden_size)", "T")
@@ -81,10 +88,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Attention, 1,
                                        "M", OpSchema::Optional)
                                 .Input(4, "past", "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).", "T", OpSchema::Optional)
                                 .Input(5, "extra_add", "additional add to QxK' with shape (batch_size, num_heads, sequence_length, sequence_length).", "T", OpSchema::Optional)
+                                .Input(6, "past_sequence_length", "number of valid tokens in past state with shape (1). Required when past_present_share_buffer is 1.", "M", OpSchema::Optional)
                                 .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
                                 .Output(1, "present", "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)", "T", OpSchema::Optional)
                                 .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float tensors.")
-                                .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index to integer types")
+                                .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask index and past sequence length to integer types")
                                 .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
                                   constexpr int past_input_index = 4;
                                   AttentionTypeAndShapeInference(ctx, past_input_index);
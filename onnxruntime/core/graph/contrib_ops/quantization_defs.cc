@@ -417,6 +417,62 @@ C (int32) = (A - A_zero_point) * (B - B_zero_point)
         ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
       }));
 
+  static const char* MatMulNBits_ver1_doc = R"DOC(
+MatMulNBits performs a matrix multiplication where the right-hand-side matrix (weights) is quantized to N bits.
+
+Only the weights are quantized: input A and output Y are float, and B is dequantized on the fly as
+  Y = A * dequantize(B) [+ bias]
+B is a 2D [K, N] matrix quantized blockwise along K. Each block of 'block_size' consecutive elements of a column has
+its own scale and zero point, and an element is dequantized as (q - zero_point) * scale.
+
+Input B is stored as uint8 with shape [N, n_blocks_per_col, blob_size], where
+  n_blocks_per_col = (K + block_size - 1) / block_size
+  blob_size = block_size * bits / 8
+so each column is stored contiguously. With bits=4, two elements are packed in one byte, the first in the low nibble.
+The last block of a column is padded with zeros when K is not a multiple of block_size.
+Input scales has n_blocks_per_col scales per column, stored as [N * n_blocks_per_col].
+Input zero_points is optional. It is stored with 'bits' bits per zero point, packed in the same order as the scales
+and padded to a whole byte per column: [N * ((n_blocks_per_col * bits + 7) / 8)]. The default zero point is
+2^(bits - 1).
+)DOC";
+
+  ONNX_MS_OPERATOR_SET_SCHEMA(MatMulNBits, 1, OpSchema()
+      .SetDoc(MatMulNBits_ver1_doc)
+      .Attr("K", "size of each input feature", AttributeProto::INT)
+      .Attr("N", "size of each output feature", AttributeProto::INT)
+      .Attr("bits", "number of bits used for weight quantization, 4 or 8", AttributeProto::INT, static_cast<int64_t>(4))
+      .Attr("block_size",
+            "number of elements of a column quantized together. It must be a power of 2 and not smaller than 16, "
+            "like 16, 32, 64, 128 or 256.",
+            AttributeProto::INT)
+      .Input(0, "A", "The input tensor, not quantized", "T1")
+      .Input(1, "B", "Quantized weights with shape [N, n_blocks_per_col, blob_size]", "T2")
+      .Input(2, "scales", "quantization scale", "T1")
+      .Input(3, "zero_points", "quantization zero points", "T2", OpSchema::Optional)
+      .Input(4,
+             "bias",
+             "1D input tensor, whose dimension is N",
+             "T1",
+             OpSchema::Optional)
+      .Output(0, "Y", "tensor. The output tensor has the same rank as the input. ", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain quantized weight types to uint8.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+
+        const auto& a_shape = getInputShape(ctx, 0);
+        if (a_shape.dim_size() == 0) {
+          fail_shape_inference("Input A of MatMulNBits must not be a scalar");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto y_shape(a_shape);
+        y_shape.mutable_dim(y_shape.dim_size() - 1)->set_dim_value(getAttribute(ctx, "N", 0));
+        updateOutputShape(ctx, 0, y_shape);
+      }));
+
   ONNX_MS_OPERATOR_SET_SCHEMA(QLinearAdd, 1, OpSchema()
       .FillUsing(QLinearMathDocGenerator("addition",
                                          "C = (A_scale * (A - A_zero_point) + B_scale * (B - B_zero_point))/C_scale + C_zero_point")));
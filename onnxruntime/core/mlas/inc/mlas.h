@@ -939,6 +939,42 @@ MlasComputeTanh(
     size_t N
     );
 
+/**
+ * @brief Layer normalization of one vector of N elements, optionally fused
+ *        with a residual add: X = Input + Skip + Bias,
+ *        Output = (X - Mean(X)) / Sqrt(Var(X) + Epsilon) * Scale + Shift
+ *
+ * @param Input       input vector
+ * @param Skip        optional residual vector added to the input, may be nullptr
+ * @param Bias        optional bias vector added to the input, may be nullptr
+ * @param SumOutput   optional buffer receiving X, may be nullptr
+ * @param Scale       scale (gamma) vector
+ * @param Shift       optional shift (beta) vector, may be nullptr
+ * @param Output      output vector, may alias Input
+ * @param N           number of elements
+ * @param Epsilon     value added to the variance
+ * @param Simplified  true to compute the root mean square normalization
+ *                    (no mean subtraction)
+ * @param Mean        optionally receives the mean, may be nullptr
+ * @param InvStdDev   optionally receives 1 / Sqrt(Var(X) + Epsilon), may be nullptr
+ */
+void
+MLASCALL
+MlasComputeLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -952,6 +988,199 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+/**
+ * @brief Formats of the 16-bit floating point routines
+ */
+enum MLAS_HALF_TYPE {
+    MlasHalfTypeFp16,   /**< IEEE 754 half precision */
+    MlasHalfTypeBf16,   /**< bfloat16 */
+};
+
+void
+MLASCALL
+MlasConvertHalfToFloat(
+    MLAS_HALF_TYPE Type,
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+void
+MLASCALL
+MlasConvertFloatToHalf(
+    MLAS_HALF_TYPE Type,
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    );
+
+/**
+ * @brief Supply matrices data information to the half precision and bfloat16 gemm functions
+ */
+struct MLAS_HALF_GEMM_DATA_PARAMS {
+    const uint16_t* A = nullptr;    /**< Supplies the address of matrix A */
+    size_t lda = 0;                 /**< Supplies the first dimension of matrix A. */
+    const void* PackedB = nullptr;  /**< Supplies the address of matrix B packed by MlasHalfGemmPackB */
+    uint16_t* C = nullptr;          /**< Supplies the address of matrix C */
+    size_t ldc = 0;                 /**< Supplies the first dimension of matrix C. */
+    float alpha = 1.0f;             /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
+    float beta = 0.0f;              /**< Supplies the scalar beta multiplier (see SGEMM definition) */
+};
+
+/**
+ * @brief  Batched half precision or bfloat16 matrix/matrix multiply operation
+ *         with single precision accumulation. Matrix B is pre-packed.
+ *
+ * @param Type       Supplies the format of matrices A, B and C.
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param N          Supplies the number of columns of matrix B and matrix C.
+ * @param K          Supplies the number of columns of matrix A and the number
+                     of rows of matrix B.
+ * @param Data       A array of matrices data parameters
+ * @param BatchSize  Supplies number of multiplications in this batch
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasHalfGemmBatch(
+    MLAS_HALF_TYPE Type,
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const uint16_t* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+//
+// Weight only blockwise quantized matrix multiply routines.
+//
+// Matrix B is quantized to BlkBitWidth bit unsigned values in blocks of BlkLen
+// consecutive elements along K, each block having its own scale and zero point.
+// The quantized data is stored column by column: for column n, block b holds
+// ceil(BlkLen * BlkBitWidth / 8) bytes at offset (n * BlockCountK + b) times
+// the block size, where BlockCountK = ceil(K / BlkLen). 4-bit values are packed
+// two per byte, the first element in the low nibble. The scales are stored as
+// [N][BlockCountK]. The optional zero points are stored per column in the same
+// bit width as the data and padded to a whole byte per column; when they are
+// absent the zero point is 2^(BlkBitWidth - 1).
+//
+
+/**
+ * @brief Supply matrices data information to the blockwise quantized gemm functions
+ */
+struct MLAS_QNBIT_GEMM_DATA_PARAMS {
+    const float* A = nullptr;               /**< Supplies the address of matrix A */
+    size_t lda = 0;                         /**< Supplies the first dimension of matrix A. */
+    const uint8_t* QuantBData = nullptr;    /**< Supplies the quantized data of matrix B */
+    const float* QuantBScale = nullptr;     /**< Supplies the block scales of matrix B */
+    const uint8_t* QuantBZeroPoint = nullptr; /**< Supplies the block zero points of matrix B, optional */
+    const float* Bias = nullptr;            /**< Supplies the bias vector of length N, optional */
+    float* C = nullptr;                     /**< Supplies the address of matrix C */
+    size_t ldc = 0;                         /**< Supplies the first dimension of matrix C. */
+};
+
+/**
+ * @brief Determines whether the blockwise quantized gemm supports the
+ *        quantization parameters.
+ *
+ * @param BlkBitWidth   Supplies the number of bits of a quantized value.
+ * @param BlkLen        Supplies the number of quantized values in a block.
+ */
+bool
+MLASCALL
+MlasIsQNBitGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    );
+
+/**
+ * @brief Returns the size in bytes of the quantized data, the number of
+ *        scales and the size in bytes of the zero points of matrix B.
+ */
+void
+MLASCALL
+MlasQNBitGemmQuantBSizes(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t* QuantBDataSize,
+    size_t* QuantBScaleCount,
+    size_t* QuantBZeroPointSize
+    );
+
+/**
+ * @brief  Batched single precision matrix/matrix multiply operation with a
+ *         blockwise quantized matrix B: C = A * dequantize(B) + Bias.
+ *         Matrix B is dequantized inside the operation one cache block at a
+ *         time, so only the quantized weights are read from memory.
+ *
+ * @param M            Supplies the number of rows of matrix A and matrix C.
+ * @param N            Supplies the number of columns of matrix B and matrix C.
+ * @param K            Supplies the number of columns of matrix A and the number
+                       of rows of matrix B.
+ * @param BatchN       Supplies number of multiplications in this batch
+ * @param BlkBitWidth  Supplies the number of bits of a quantized value, 4 or 8.
+ * @param BlkLen       Supplies the number of quantized values in a block.
+ * @param Data         A array of matrices data parameters
+ * @param ThreadPool   Supplies the thread pool object to use, else nullptr if the
+                       base library threading support should be used.
+ */
+void
+MLASCALL
+MlasQNBitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const MLAS_QNBIT_GEMM_DATA_PARAMS* Data,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Quantizes a row major K x N matrix B to the blockwise format used by
+ *        MlasQNBitGemmBatch. Symmetric quantization is used when
+ *        QuantBZeroPoint is nullptr.
+ */
+void
+MLASCALL
+MlasQNBitGemmQuantizeB(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Transpose routines.
 //
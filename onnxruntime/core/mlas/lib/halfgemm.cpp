@@ -0,0 +1,721 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm.cpp
+
+Abstract:
+
+    This module implements the matrix/matrix multiply operation for half
+    precision (fp16) and bfloat16 matrices.
+
+    The matrices are stored as 16-bit values and the multiplication is done
+    with single precision accumulation: blocks of matrix A and the packed
+    matrix B are converted to single precision in local buffers and passed to
+    the SGEMM kernels, and the single precision result is converted back to
+    16-bit values once all of K has been accumulated.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the block sizes of the operation.
+//
+// N.B. The packed matrix B is stored in blocks of MLAS_HGEMM_STRIDEK rows by
+// MLAS_HGEMM_STRIDEN columns, so changing these changes the packed format.
+//
+
+#define MLAS_HGEMM_STRIDEM                  64
+#define MLAS_HGEMM_STRIDEN                  64
+#define MLAS_HGEMM_STRIDEK                  128
+
+MLAS_FORCEINLINE
+float
+MlasFp16ToFloat(
+    uint16_t Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision value to single precision.
+
+Arguments:
+
+    Value - Supplies the half precision value.
+
+Return Value:
+
+    Returns the single precision value.
+
+--*/
+{
+    constexpr uint32_t ShiftedExponent = 0x7C00u << 13;
+    constexpr float DenormalMagic = 6.103515625e-05f;   // 2^-14
+
+    uint32_t Bits = uint32_t(Value & 0x7FFFu) << 13;
+    const uint32_t Exponent = Bits & ShiftedExponent;
+
+    Bits += (127 - 15) << 23;
+
+    float Result;
+
+    if (Exponent == ShiftedExponent) {
+
+        //
+        // Infinity or NaN: extend the exponent.
+        //
+
+        Bits += (128 - 16) << 23;
+        memcpy(&Result, &Bits, sizeof(Result));
+
+    } else if (Exponent == 0) {
+
+        //
+        // Zero or denormal: renormalize with a floating point subtraction.
+        //
+
+        Bits += 1 << 23;
+        memcpy(&Result, &Bits, sizeof(Result));
+        Result -= DenormalMagic;
+
+    } else {
+
+        memcpy(&Result, &Bits, sizeof(Result));
+    }
+
+    return (Value & 0x8000u) != 0 ? -Result : Result;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToFp16(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to half precision, rounding
+    to nearest even.
+
+Arguments:
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the half precision value.
+
+--*/
+{
+    constexpr uint32_t Float32Infinity = 255u << 23;
+    constexpr uint32_t Float16Maximum = (127u + 16u) << 23;
+    constexpr uint32_t DenormalMagicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    const uint32_t Sign = Bits & 0x80000000u;
+    Bits ^= Sign;
+
+    uint16_t Result;
+
+    if (Bits >= Float16Maximum) {
+
+        //
+        // Overflow to infinity, or NaN (quieted).
+        //
+
+        Result = (Bits > Float32Infinity) ? 0x7E00 : 0x7C00;
+
+    } else if (Bits < (113u << 23)) {
+
+        //
+        // Denormal or zero: let the floating point addition do the rounding.
+        //
+
+        float Denormal;
+        float DenormalMagic;
+        memcpy(&Denormal, &Bits, sizeof(Denormal));
+        memcpy(&DenormalMagic, &DenormalMagicBits, sizeof(DenormalMagic));
+
+        Denormal += DenormalMagic;
+        memcpy(&Bits, &Denormal, sizeof(Bits));
+
+        Result = uint16_t(Bits - DenormalMagicBits);
+
+    } else {
+
+        const uint32_t MantissaOdd = (Bits >> 13) & 1;
+
+        Bits += (uint32_t(15 - 127) << 23) + 0xFFF;
+        Bits += MantissaOdd;
+
+        Result = uint16_t(Bits >> 13);
+    }
+
+    return uint16_t(Result | (Sign >> 16));
+}
+
+MLAS_FORCEINLINE
+float
+MlasBf16ToFloat(
+    uint16_t Value
+    )
+{
+    const uint32_t Bits = uint32_t(Value) << 16;
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+
+    return Result;
+}
+
+MLAS_FORCEINLINE
+uint16_t
+MlasFloatToBf16(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision value to bfloat16, rounding to
+    nearest even.
+
+Arguments:
+
+    Value - Supplies the single precision value.
+
+Return Value:
+
+    Returns the bfloat16 value.
+
+--*/
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    //
+    // N.B. The NaN case is selected instead of branched on so that loops of
+    // this routine vectorize.
+    //
+
+    const uint32_t Rounded = Bits + 0x7FFFu + ((Bits >> 16) & 1);
+    const uint32_t Quieted = Bits | 0x00400000u;
+
+    return uint16_t((((Bits & 0x7FFFFFFFu) > 0x7F800000u) ? Quieted : Rounded) >> 16);
+}
+
+void
+MLASCALL
+MlasConvertFp16ToFloatKernel(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision.
+
+Arguments:
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasFp16ToFloat(Source[i]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToFp16Kernel(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision, rounding to nearest even.
+
+Arguments:
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MlasFloatToFp16(Source[i]);
+    }
+}
+
+void
+MLASCALL
+MlasConvertHalfToFloat(
+    MLAS_HALF_TYPE Type,
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision or bfloat16 values to
+    single precision.
+
+Arguments:
+
+    Type - Supplies the format of the source values.
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Type == MlasHalfTypeBf16) {
+        for (size_t i = 0; i < Count; i++) {
+            Destination[i] = MlasBf16ToFloat(Source[i]);
+        }
+    } else {
+#if defined(MLAS_TARGET_AMD64)
+        GetMlasPlatform().ConvertFp16ToFloatKernel(Source, Destination, Count);
+#else
+        MlasConvertFp16ToFloatKernel(Source, Destination, Count);
+#endif
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalf(
+    MLAS_HALF_TYPE Type,
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision or bfloat16, rounding to nearest even.
+
+Arguments:
+
+    Type - Supplies the format of the destination values.
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Type == MlasHalfTypeBf16) {
+        for (size_t i = 0; i < Count; i++) {
+            Destination[i] = MlasFloatToBf16(Source[i]);
+        }
+    } else {
+#if defined(MLAS_TARGET_AMD64)
+        GetMlasPlatform().ConvertFloatToFp16Kernel(Source, Destination, Count);
+#else
+        MlasConvertFloatToFp16Kernel(Source, Destination, Count);
+#endif
+    }
+}
+
+size_t
+MLASCALL
+MlasHalfGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer
+    of a half precision or bfloat16 matrix multiply.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer.
+
+--*/
+{
+    const size_t BytesRequired = N * K * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired = (BytesRequired + BufferAlignment - 1) &
+        ~(BufferAlignment - 1);
+
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasHalfGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const uint16_t* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the destination buffer. The
+    destination buffer should be sized based on MlasHalfGemmPackBSize().
+
+    The values are not converted, so the packed buffer is half the size of the
+    buffer used by the single precision routines. Matrix B is stored as blocks
+    of up to MLAS_HGEMM_STRIDEK rows by MLAS_HGEMM_STRIDEN columns. Each block
+    is row major and physically contiguous, so a block can be converted to
+    single precision in a single pass.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    uint16_t* D = reinterpret_cast<uint16_t*>(PackedB);
+
+    size_t CountN;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = std::min(N - n, size_t(MLAS_HGEMM_STRIDEN));
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_HGEMM_STRIDEK));
+
+            if (TransB == CblasNoTrans) {
+
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    std::copy_n(B + (k + kk) * ldb + n, CountN, D);
+                    D += CountN;
+                }
+
+            } else {
+
+                for (size_t kk = 0; kk < CountK; kk++) {
+                    const uint16_t* b = B + n * ldb + (k + kk);
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        D[nn] = b[nn * ldb];
+                    }
+                    D += CountN;
+                }
+            }
+        }
+    }
+}
+
+void
+MlasHalfGemmOperation(
+    MLAS_HALF_TYPE Type,
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    const uint16_t* A,
+    uint16_t* C
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a segment of the half precision or bfloat16
+    matrix/matrix multiply operation.
+
+Arguments:
+
+    Type - Supplies the format of the matrices.
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column of the segment. This is a
+        multiple of MLAS_HGEMM_STRIDEN.
+
+    RangeCountN - Supplies the number of columns of the segment.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    Data - Supplies the data parameters of the operation.
+
+    A - Supplies the address of the first row of matrix A of the segment.
+
+    C - Supplies the address of the first row of matrix C of the segment.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelA[MLAS_HGEMM_STRIDEM * MLAS_HGEMM_STRIDEK], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_HGEMM_STRIDEK * MLAS_HGEMM_STRIDEN], 64);
+    MLAS_DECLSPEC_ALIGN(float PanelC[MLAS_HGEMM_STRIDEM * MLAS_HGEMM_STRIDEN], 64);
+
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+    const float alpha = Data->alpha;
+    const float beta = Data->beta;
+
+    //
+    // Step through each block of matrix C along the M dimension.
+    //
+
+    size_t CountM;
+
+    for (size_t m = 0; m < M; m += CountM) {
+
+        CountM = std::min(M - m, size_t(MLAS_HGEMM_STRIDEM));
+
+        //
+        // Step through each slice of matrix B along the N dimension.
+        //
+
+        size_t CountN;
+
+        for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+            const size_t SliceStartN = RangeStartN + n;
+
+            CountN = std::min(RangeCountN - n, size_t(MLAS_HGEMM_STRIDEN));
+
+            uint16_t* c = C + m * ldc + n;
+
+            if (beta != 0.0f) {
+                for (size_t mm = 0; mm < CountM; mm++) {
+                    MlasConvertHalfToFloat(Type, c + mm * ldc, PanelC + mm * CountN, CountN);
+                }
+            }
+
+            if (K == 0) {
+                for (size_t i = 0; i < CountM * CountN; i++) {
+                    PanelC[i] = (beta != 0.0f) ? PanelC[i] * beta : 0.0f;
+                }
+            }
+
+            //
+            // Step through each slice of matrix B along the K dimension,
+            // accumulating in single precision.
+            //
+
+            const uint16_t* pb = reinterpret_cast<const uint16_t*>(Data->PackedB) + SliceStartN * K;
+            float CurrentBeta = beta;
+
+            size_t CountK;
+
+            for (size_t k = 0; k < K; k += CountK) {
+
+                CountK = std::min(K - k, size_t(MLAS_HGEMM_STRIDEK));
+
+                MlasConvertHalfToFloat(Type, pb, PanelB, CountK * CountN);
+                pb += CountK * CountN;
+
+                if (TransA == CblasNoTrans) {
+
+                    for (size_t mm = 0; mm < CountM; mm++) {
+                        MlasConvertHalfToFloat(Type, A + (m + mm) * lda + k, PanelA + mm * CountK, CountK);
+                    }
+
+                } else {
+
+                    for (size_t kk = 0; kk < CountK; kk++) {
+                        const uint16_t* a = A + (k + kk) * lda + m;
+                        for (size_t mm = 0; mm < CountM; mm++) {
+                            PanelA[mm * CountK + kk] = (Type == MlasHalfTypeBf16) ?
+                                MlasBf16ToFloat(a[mm]) : MlasFp16ToFloat(a[mm]);
+                        }
+                    }
+                }
+
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, CountM, CountN, CountK,
+                    alpha, PanelA, CountK, PanelB, CountN, CurrentBeta, PanelC, CountN);
+
+                CurrentBeta = 1.0f;
+            }
+
+            for (size_t mm = 0; mm < CountM; mm++) {
+                MlasConvertFloatToHalf(Type, PanelC + mm * CountN, c + mm * ldc, CountN);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasHalfGemmBatch(
+    MLAS_HALF_TYPE Type,
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_HALF_GEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads. Matrix B is partitioned
+    // on block boundaries so that each thread converts whole blocks.
+    //
+
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+
+    const size_t BlockedN = (N + MLAS_HGEMM_STRIDEN - 1) / MLAS_HGEMM_STRIDEN;
+
+    if (N > M && BlockedN > 1) {
+
+        if (size_t(ThreadsPerGemm) > BlockedN) {
+            ThreadsPerGemm = ptrdiff_t(BlockedN);
+        }
+
+        ThreadCountM = 1;
+        ThreadCountN = ThreadsPerGemm;
+
+    } else {
+
+        if (size_t(ThreadsPerGemm) > M) {
+            ThreadsPerGemm = ptrdiff_t(M);
+        }
+
+        ThreadCountM = ThreadsPerGemm;
+        ThreadCountN = 1;
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+        [=](ptrdiff_t tid)
+    {
+        const ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
+        const ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+
+        const ptrdiff_t ThreadIdM = ThreadIdx / ThreadCountN;
+        const ptrdiff_t ThreadIdN = ThreadIdx % ThreadCountN;
+
+        size_t RangeStartM;
+        size_t RangeCountM;
+
+        MlasPartitionWork(ThreadIdM, ThreadCountM, M, &RangeStartM, &RangeCountM);
+
+        size_t RangeStartN;
+        size_t RangeCountN;
+
+        MlasPartitionWork(ThreadIdN, ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+        RangeStartN *= MLAS_HGEMM_STRIDEN;
+        RangeCountN *= MLAS_HGEMM_STRIDEN;
+
+        if (RangeCountM == 0 || RangeStartN >= N) {
+            return;
+        }
+
+        RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+        const MLAS_HALF_GEMM_DATA_PARAMS* DataParams = &Data[GemmIdx];
+
+        const uint16_t* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? DataParams->lda : 1);
+        uint16_t* C = DataParams->C + RangeStartM * DataParams->ldc + RangeStartN;
+
+        MlasHalfGemmOperation(Type, TransA, RangeCountM, RangeStartN, RangeCountN, K,
+            DataParams, A, C);
+    });
+}
@@ -0,0 +1,101 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx2.cpp
+
+Abstract:
+
+    This module implements the conversion kernels between half precision and
+    single precision with F16C instructions. The remainder of the buffer is
+    converted through a local buffer to avoid reading or writing past the end
+    of the source or destination.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertFp16ToFloatKernelF16C(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 16) {
+
+        __m256 Vector0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)Source));
+        __m256 Vector1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(Source + 8)));
+
+        _mm256_storeu_ps(Destination, Vector0);
+        _mm256_storeu_ps(Destination + 8, Vector1);
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    while (Count > 0) {
+
+        const size_t CountThisIteration = std::min(Count, size_t(8));
+
+        uint16_t SourceBuffer[8] = {};
+        float DestinationBuffer[8];
+
+        std::copy_n(Source, CountThisIteration, SourceBuffer);
+
+        _mm256_storeu_ps(DestinationBuffer, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)SourceBuffer)));
+
+        std::copy_n(DestinationBuffer, CountThisIteration, Destination);
+
+        Source += CountThisIteration;
+        Destination += CountThisIteration;
+        Count -= CountThisIteration;
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToFp16KernelF16C(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 16) {
+
+        __m128i Vector0 = _mm256_cvtps_ph(_mm256_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m128i Vector1 = _mm256_cvtps_ph(_mm256_loadu_ps(Source + 8), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128((__m128i*)Destination, Vector0);
+        _mm_storeu_si128((__m128i*)(Destination + 8), Vector1);
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+    while (Count > 0) {
+
+        const size_t CountThisIteration = std::min(Count, size_t(8));
+
+        float SourceBuffer[8] = {};
+        uint16_t DestinationBuffer[8];
+
+        std::copy_n(Source, CountThisIteration, SourceBuffer);
+
+        _mm_storeu_si128((__m128i*)DestinationBuffer,
+                         _mm256_cvtps_ph(_mm256_loadu_ps(SourceBuffer), _MM_FROUND_TO_NEAREST_INT));
+
+        std::copy_n(DestinationBuffer, CountThisIteration, Destination);
+
+        Source += CountThisIteration;
+        Destination += CountThisIteration;
+        Count -= CountThisIteration;
+    }
+}
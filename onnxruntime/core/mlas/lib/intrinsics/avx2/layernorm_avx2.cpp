@@ -0,0 +1,193 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel with AVX2 and FMA3
+    instructions. See layernorm.cpp for the algorithm.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddFloat32x8(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_shuffle_ps(Vector128, Vector128, 1));
+    return _mm_cvtss_f32(Vector128);
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    if (N == 0) {
+        return;
+    }
+
+    auto LoadSum = [&](size_t i) {
+        float Value = Input[i];
+        if (Skip != nullptr) {
+            Value += Skip[i];
+        }
+        if (Bias != nullptr) {
+            Value += Bias[i];
+        }
+        return Value;
+    };
+
+    auto LoadSumVector = [&](size_t i) {
+        __m256 Vector = _mm256_loadu_ps(Input + i);
+        if (Skip != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Skip + i));
+        }
+        if (Bias != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Bias + i));
+        }
+        return Vector;
+    };
+
+    //
+    // Accumulate the shifted sum and sum of squares.
+    //
+
+    const float Pivot = Simplified ? 0.0f : LoadSum(0);
+    const __m256 PivotVector = _mm256_set1_ps(Pivot);
+
+    __m256 SumVector0 = _mm256_setzero_ps();
+    __m256 SumVector1 = _mm256_setzero_ps();
+    __m256 SquareVector0 = _mm256_setzero_ps();
+    __m256 SquareVector1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+
+    for (; i + 16 <= N; i += 16) {
+
+        __m256 Vector0 = LoadSumVector(i);
+        __m256 Vector1 = LoadSumVector(i + 8);
+
+        if (SumOutput != nullptr) {
+            _mm256_storeu_ps(SumOutput + i, Vector0);
+            _mm256_storeu_ps(SumOutput + i + 8, Vector1);
+        }
+
+        Vector0 = _mm256_sub_ps(Vector0, PivotVector);
+        Vector1 = _mm256_sub_ps(Vector1, PivotVector);
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+        SquareVector0 = _mm256_fmadd_ps(Vector0, Vector0, SquareVector0);
+        SquareVector1 = _mm256_fmadd_ps(Vector1, Vector1, SquareVector1);
+    }
+
+    for (; i + 8 <= N; i += 8) {
+
+        __m256 Vector0 = LoadSumVector(i);
+
+        if (SumOutput != nullptr) {
+            _mm256_storeu_ps(SumOutput + i, Vector0);
+        }
+
+        Vector0 = _mm256_sub_ps(Vector0, PivotVector);
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+        SquareVector0 = _mm256_fmadd_ps(Vector0, Vector0, SquareVector0);
+    }
+
+    float Sum = MlasReduceAddFloat32x8(_mm256_add_ps(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x8(_mm256_add_ps(SquareVector0, SquareVector1));
+
+    for (; i < N; i++) {
+
+        const float Value = LoadSum(i);
+
+        if (SumOutput != nullptr) {
+            SumOutput[i] = Value;
+        }
+
+        const float Delta = Value - Pivot;
+
+        Sum += Delta;
+        SumSquares += Delta * Delta;
+    }
+
+    float MeanValue = 0.0f;
+    float Variance = SumSquares / float(N);
+
+    if (!Simplified) {
+        const float MeanDelta = Sum / float(N);
+        MeanValue = Pivot + MeanDelta;
+        Variance = std::max(Variance - MeanDelta * MeanDelta, 0.0f);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize and apply the scale and shift.
+    //
+
+    const float* Sums = SumOutput;
+
+    if (Sums == nullptr && Skip == nullptr && Bias == nullptr) {
+        Sums = Input;
+    }
+
+    const __m256 MeanVector = _mm256_set1_ps(MeanValue);
+    const __m256 InvStdDevVector = _mm256_set1_ps(InvStdDevValue);
+
+    for (i = 0; i + 8 <= N; i += 8) {
+
+        __m256 Vector = (Sums != nullptr) ? _mm256_loadu_ps(Sums + i) : LoadSumVector(i);
+
+        Vector = _mm256_mul_ps(_mm256_sub_ps(Vector, MeanVector), InvStdDevVector);
+
+        if (Shift != nullptr) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_loadu_ps(Scale + i), _mm256_loadu_ps(Shift + i));
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_loadu_ps(Scale + i));
+        }
+
+        _mm256_storeu_ps(Output + i, Vector);
+    }
+
+    for (; i < N; i++) {
+
+        const float Value = (Sums != nullptr) ? Sums[i] : LoadSum(i);
+        const float Normalized = (Value - MeanValue) * InvStdDevValue * Scale[i];
+
+        Output[i] = (Shift != nullptr) ? Normalized + Shift[i] : Normalized;
+    }
+}
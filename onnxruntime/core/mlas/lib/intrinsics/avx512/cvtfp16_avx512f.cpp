@@ -0,0 +1,97 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cvtfp16_avx512f.cpp
+
+Abstract:
+
+    This module implements the conversion kernels between half precision and
+    single precision with AVX512F instructions. The remainder of the single
+    precision buffer is accessed with masked loads and stores and the
+    remainder of the half precision buffer through a local buffer.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasConvertFp16ToFloatKernelAvx512F(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 32) {
+
+        __m512 Vector0 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)Source));
+        __m512 Vector1 = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(Source + 16)));
+
+        _mm512_storeu_ps(Destination, Vector0);
+        _mm512_storeu_ps(Destination + 16, Vector1);
+
+        Source += 32;
+        Destination += 32;
+        Count -= 32;
+    }
+
+    while (Count > 0) {
+
+        const size_t CountThisIteration = std::min(Count, size_t(16));
+        const __mmask16 Mask = __mmask16((1u << CountThisIteration) - 1);
+
+        uint16_t SourceBuffer[16] = {};
+
+        std::copy_n(Source, CountThisIteration, SourceBuffer);
+
+        _mm512_mask_storeu_ps(Destination, Mask, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)SourceBuffer)));
+
+        Source += CountThisIteration;
+        Destination += CountThisIteration;
+        Count -= CountThisIteration;
+    }
+}
+
+void
+MLASCALL
+MlasConvertFloatToFp16KernelAvx512F(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    )
+{
+    while (Count >= 32) {
+
+        __m256i Vector0 = _mm512_cvtps_ph(_mm512_loadu_ps(Source), _MM_FROUND_TO_NEAREST_INT);
+        __m256i Vector1 = _mm512_cvtps_ph(_mm512_loadu_ps(Source + 16), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm256_storeu_si256((__m256i*)Destination, Vector0);
+        _mm256_storeu_si256((__m256i*)(Destination + 16), Vector1);
+
+        Source += 32;
+        Destination += 32;
+        Count -= 32;
+    }
+
+    while (Count > 0) {
+
+        const size_t CountThisIteration = std::min(Count, size_t(16));
+        const __mmask16 Mask = __mmask16((1u << CountThisIteration) - 1);
+
+        uint16_t DestinationBuffer[16];
+
+        _mm256_storeu_si256((__m256i*)DestinationBuffer,
+                            _mm512_cvtps_ph(_mm512_maskz_loadu_ps(Mask, Source), _MM_FROUND_TO_NEAREST_INT));
+
+        std::copy_n(DestinationBuffer, CountThisIteration, Destination);
+
+        Source += CountThisIteration;
+        Destination += CountThisIteration;
+        Count -= CountThisIteration;
+    }
+}
@@ -0,0 +1,158 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel with AVX512F
+    instructions. See layernorm.cpp for the algorithm. The remainder of the
+    vector is processed with masked loads and stores.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    if (N == 0) {
+        return;
+    }
+
+    auto LoadSumVector = [&](size_t i, __mmask16 Mask) {
+        __m512 Vector = _mm512_maskz_loadu_ps(Mask, Input + i);
+        if (Skip != nullptr) {
+            Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Skip + i));
+        }
+        if (Bias != nullptr) {
+            Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Bias + i));
+        }
+        return Vector;
+    };
+
+    //
+    // Accumulate the shifted sum and sum of squares.
+    //
+
+    float Pivot = 0.0f;
+
+    if (!Simplified) {
+        Pivot = Input[0] + ((Skip != nullptr) ? Skip[0] : 0.0f) + ((Bias != nullptr) ? Bias[0] : 0.0f);
+    }
+
+    const __m512 PivotVector = _mm512_set1_ps(Pivot);
+
+    __m512 SumVector0 = _mm512_setzero_ps();
+    __m512 SumVector1 = _mm512_setzero_ps();
+    __m512 SquareVector0 = _mm512_setzero_ps();
+    __m512 SquareVector1 = _mm512_setzero_ps();
+
+    size_t i = 0;
+
+    for (; i + 32 <= N; i += 32) {
+
+        __m512 Vector0 = LoadSumVector(i, 0xFFFF);
+        __m512 Vector1 = LoadSumVector(i + 16, 0xFFFF);
+
+        if (SumOutput != nullptr) {
+            _mm512_storeu_ps(SumOutput + i, Vector0);
+            _mm512_storeu_ps(SumOutput + i + 16, Vector1);
+        }
+
+        Vector0 = _mm512_sub_ps(Vector0, PivotVector);
+        Vector1 = _mm512_sub_ps(Vector1, PivotVector);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm512_add_ps(SumVector1, Vector1);
+        SquareVector0 = _mm512_fmadd_ps(Vector0, Vector0, SquareVector0);
+        SquareVector1 = _mm512_fmadd_ps(Vector1, Vector1, SquareVector1);
+    }
+
+    for (; i < N; i += 16) {
+
+        const __mmask16 Mask = (N - i >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << (N - i)) - 1);
+
+        __m512 Vector0 = LoadSumVector(i, Mask);
+
+        if (SumOutput != nullptr) {
+            _mm512_mask_storeu_ps(SumOutput + i, Mask, Vector0);
+        }
+
+        Vector0 = _mm512_maskz_sub_ps(Mask, Vector0, PivotVector);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+        SquareVector0 = _mm512_fmadd_ps(Vector0, Vector0, SquareVector0);
+    }
+
+    const float Sum = _mm512_reduce_add_ps(_mm512_add_ps(SumVector0, SumVector1));
+    const float SumSquares = _mm512_reduce_add_ps(_mm512_add_ps(SquareVector0, SquareVector1));
+
+    float MeanValue = 0.0f;
+    float Variance = SumSquares / float(N);
+
+    if (!Simplified) {
+        const float MeanDelta = Sum / float(N);
+        MeanValue = Pivot + MeanDelta;
+        Variance = std::max(Variance - MeanDelta * MeanDelta, 0.0f);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize and apply the scale and shift.
+    //
+
+    const float* Sums = SumOutput;
+
+    if (Sums == nullptr && Skip == nullptr && Bias == nullptr) {
+        Sums = Input;
+    }
+
+    const __m512 MeanVector = _mm512_set1_ps(MeanValue);
+    const __m512 InvStdDevVector = _mm512_set1_ps(InvStdDevValue);
+
+    for (i = 0; i < N; i += 16) {
+
+        const __mmask16 Mask = (N - i >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << (N - i)) - 1);
+
+        __m512 Vector = (Sums != nullptr) ? _mm512_maskz_loadu_ps(Mask, Sums + i) : LoadSumVector(i, Mask);
+
+        Vector = _mm512_mul_ps(_mm512_sub_ps(Vector, MeanVector), InvStdDevVector);
+
+        if (Shift != nullptr) {
+            Vector = _mm512_fmadd_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale + i), _mm512_maskz_loadu_ps(Mask, Shift + i));
+        } else {
+            Vector = _mm512_mul_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale + i));
+        }
+
+        _mm512_mask_storeu_ps(Output + i, Mask, Vector);
+    }
+}
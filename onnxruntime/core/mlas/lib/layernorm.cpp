@@ -0,0 +1,273 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute the layer normalization of a
+    vector, optionally fused with a residual (skip) add and a bias add.
+
+    The mean and variance are accumulated in a single pass over the input.
+    The values are shifted by the first element of the vector before they are
+    squared, so the variance does not suffer from the cancellation of the
+    textbook sum of squares formula when the mean is large relative to the
+    spread of the values. The second pass applies the affine transform.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLayerNormF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the layer normalization
+    operation. See MlasComputeLayerNorm for the argument descriptions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0) {
+        return;
+    }
+
+    auto LoadSum = [&](size_t i) {
+        float Value = Input[i];
+        if (Skip != nullptr) {
+            Value += Skip[i];
+        }
+        if (Bias != nullptr) {
+            Value += Bias[i];
+        }
+        return Value;
+    };
+
+    auto LoadSumVector = [&](size_t i) {
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + i);
+        if (Skip != nullptr) {
+            Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Skip + i));
+        }
+        if (Bias != nullptr) {
+            Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + i));
+        }
+        return Vector;
+    };
+
+    //
+    // Accumulate the shifted sum and sum of squares.
+    //
+
+    const float Pivot = Simplified ? 0.0f : LoadSum(0);
+    const MLAS_FLOAT32X4 PivotVector = MlasBroadcastFloat32x4(Pivot);
+
+    MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SquareVector0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SquareVector1 = MlasZeroFloat32x4();
+
+    size_t i = 0;
+
+    for (; i + 8 <= N; i += 8) {
+
+        MLAS_FLOAT32X4 Vector0 = LoadSumVector(i);
+        MLAS_FLOAT32X4 Vector1 = LoadSumVector(i + 4);
+
+        if (SumOutput != nullptr) {
+            MlasStoreFloat32x4(SumOutput + i, Vector0);
+            MlasStoreFloat32x4(SumOutput + i + 4, Vector1);
+        }
+
+        Vector0 = MlasSubtractFloat32x4(Vector0, PivotVector);
+        Vector1 = MlasSubtractFloat32x4(Vector1, PivotVector);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+        SquareVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SquareVector0);
+        SquareVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SquareVector1);
+    }
+
+    for (; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Vector0 = LoadSumVector(i);
+
+        if (SumOutput != nullptr) {
+            MlasStoreFloat32x4(SumOutput + i, Vector0);
+        }
+
+        Vector0 = MlasSubtractFloat32x4(Vector0, PivotVector);
+
+        SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+        SquareVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SquareVector0);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+    float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SquareVector0, SquareVector1));
+
+    for (; i < N; i++) {
+
+        const float Value = LoadSum(i);
+
+        if (SumOutput != nullptr) {
+            SumOutput[i] = Value;
+        }
+
+        const float Delta = Value - Pivot;
+
+        Sum += Delta;
+        SumSquares += Delta * Delta;
+    }
+
+    float MeanValue = 0.0f;
+    float Variance = SumSquares / float(N);
+
+    if (!Simplified) {
+        const float MeanDelta = Sum / float(N);
+        MeanValue = Pivot + MeanDelta;
+        Variance = std::max(Variance - MeanDelta * MeanDelta, 0.0f);
+    }
+
+    const float InvStdDevValue = 1.0f / std::sqrt(Variance + Epsilon);
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize and apply the scale and shift. The sum of the inputs is read
+    // back when it was stored, else it is recomputed. The output may alias the
+    // input.
+    //
+
+    const float* Sums = SumOutput;
+
+    if (Sums == nullptr && Skip == nullptr && Bias == nullptr) {
+        Sums = Input;
+    }
+
+    const MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(MeanValue);
+    const MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDevValue);
+
+    for (i = 0; i + 4 <= N; i += 4) {
+
+        MLAS_FLOAT32X4 Vector = (Sums != nullptr) ? MlasLoadFloat32x4(Sums + i) : LoadSumVector(i);
+
+        Vector = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(Vector, MeanVector), InvStdDevVector);
+
+        if (Shift != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, MlasLoadFloat32x4(Scale + i), MlasLoadFloat32x4(Shift + i));
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Scale + i));
+        }
+
+        MlasStoreFloat32x4(Output + i, Vector);
+    }
+
+    for (; i < N; i++) {
+
+        const float Value = (Sums != nullptr) ? Sums[i] : LoadSum(i);
+        const float Normalized = (Value - MeanValue) * InvStdDevValue * Scale[i];
+
+        Output[i] = (Shift != nullptr) ? Normalized + Shift[i] : Normalized;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLayerNorm(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of a vector:
+
+        X = Input + Skip + Bias
+        Output = (X - Mean(X)) / Sqrt(Variance(X) + Epsilon) * Scale + Shift
+
+    For the simplified (root mean square) form, the mean is not subtracted
+    and the variance is replaced by the mean of the squares.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    Skip - Optionally supplies a vector added to the input.
+
+    Bias - Optionally supplies a vector added to the input.
+
+    SumOutput - Optionally supplies the buffer receiving the sum of the input,
+        skip and bias vectors.
+
+    Scale - Supplies the scale (gamma) vector.
+
+    Shift - Optionally supplies the shift (beta) vector.
+
+    Output - Supplies the output vector. This may alias the input.
+
+    N - Supplies the number of elements of the vectors.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to compute the simplified (root mean square)
+        layer normalization.
+
+    Mean - Optionally receives the mean, which is zero for the simplified
+        form.
+
+    InvStdDev - Optionally receives the inverse of the standard deviation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().LayerNormF32Kernel(Input, Skip, Bias, SumOutput, Scale, Shift, Output,
+        N, Epsilon, Simplified, Mean, InvStdDev);
+#else
+    MlasLayerNormF32Kernel(Input, Skip, Bias, SumOutput, Scale, Shift, Output,
+        N, Epsilon, Simplified, Mean, InvStdDev);
+#endif
+}
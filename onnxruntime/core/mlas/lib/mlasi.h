@@ -517,6 +517,39 @@ void
     bool IsScalarB
     );
 
+typedef
+void
+(MLASCALL MLAS_LAYER_NORM_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* SumOutput,
+    const float* Scale,
+    const float* Shift,
+    float* Output,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FP16_TO_FLOAT_KERNEL)(
+    const uint16_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_FP16_KERNEL)(
+    const float* Source,
+    uint16_t* Destination,
+    size_t Count
+    );
+
 typedef
 void
 (MLASCALL MLAS_QUANTIZE_LINEAR_U8_KERNEL)(
@@ -676,6 +709,21 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx2;
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx512F;
+#endif
+
+    MLAS_CONVERT_FP16_TO_FLOAT_KERNEL MlasConvertFp16ToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_FP16_KERNEL MlasConvertFloatToFp16Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_CONVERT_FP16_TO_FLOAT_KERNEL MlasConvertFp16ToFloatKernelF16C;
+    MLAS_CONVERT_FLOAT_TO_FP16_KERNEL MlasConvertFloatToFp16KernelF16C;
+    MLAS_CONVERT_FP16_TO_FLOAT_KERNEL MlasConvertFp16ToFloatKernelAvx512F;
+    MLAS_CONVERT_FLOAT_TO_FP16_KERNEL MlasConvertFloatToFp16KernelAvx512F;
+#endif
+
 }
 
 //
@@ -878,6 +926,9 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* ReduceMinimumMaximumF32Kernel;
+    MLAS_LAYER_NORM_FLOAT_KERNEL* LayerNormF32Kernel;
+    MLAS_CONVERT_FP16_TO_FLOAT_KERNEL* ConvertFp16ToFloatKernel;
+    MLAS_CONVERT_FLOAT_TO_FP16_KERNEL* ConvertFloatToFp16Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL* QuantizeLinearS8Kernel;
     MLAS_QUANTIZE_LINEAR_U8_KERNEL* QuantizeLinearU8Kernel;
     uint32_t NchwcBlockSize;
@@ -182,6 +182,9 @@ Return Value:
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormF32Kernel = MlasLayerNormF32Kernel;
+    this->ConvertFp16ToFloatKernel = MlasConvertFp16ToFloatKernel;
+    this->ConvertFloatToFp16Kernel = MlasConvertFloatToFp16Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8Kernel;
@@ -284,6 +287,16 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx2;
+
+                //
+                // Check if the processor supports F16C features.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->ConvertFp16ToFloatKernel = MlasConvertFp16ToFloatKernelF16C;
+                    this->ConvertFloatToFp16Kernel = MlasConvertFloatToFp16KernelF16C;
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -332,6 +345,9 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx512F;
+                    this->ConvertFp16ToFloatKernel = MlasConvertFp16ToFloatKernelAvx512F;
+                    this->ConvertFloatToFp16Kernel = MlasConvertFloatToFp16KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
                     this->NchwcBlockSize = 16;
@@ -0,0 +1,603 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qnbitgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation with a weight only blockwise quantized matrix B.
+
+    Matrix B is stored as 4-bit or 8-bit values in blocks along K, each block
+    with its own scale and zero point. The operation dequantizes a cache block
+    of matrix B into a local single precision buffer and consumes it
+    immediately, so matrix B is read from memory in its quantized form only.
+    Few rows of matrix A (the token by token decoding case) use dot products
+    against the local buffer directly, while larger matrices pass the local
+    buffer to the SGEMM kernels.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the block sizes of the operation.
+//
+// N.B. MLAS_QNBITGEMM_STRIDEK must be a multiple of every supported block
+// length.
+//
+
+#define MLAS_QNBITGEMM_STRIDEN              16
+#define MLAS_QNBITGEMM_STRIDEK              256
+
+//
+// Define the maximum number of rows of matrix A handled with dot products.
+// Above this, the SGEMM kernels amortize packing the dequantized block.
+//
+
+#define MLAS_QNBITGEMM_GEMV_MAXIMUM_M       4
+
+bool
+MLASCALL
+MlasIsQNBitGemmAvailable(
+    size_t BlkBitWidth,
+    size_t BlkLen
+    )
+{
+    if (BlkBitWidth != 4 && BlkBitWidth != 8) {
+        return false;
+    }
+
+    return BlkLen >= 16 && BlkLen <= MLAS_QNBITGEMM_STRIDEK && (BlkLen & (BlkLen - 1)) == 0;
+}
+
+void
+MLASCALL
+MlasQNBitGemmQuantBSizes(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    size_t* QuantBDataSize,
+    size_t* QuantBScaleCount,
+    size_t* QuantBZeroPointSize
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sizes of the buffers holding a blockwise
+    quantized matrix B.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BlkBitWidth - Supplies the number of bits of a quantized value.
+
+    BlkLen - Supplies the number of quantized values in a block.
+
+    QuantBDataSize - Receives the size in bytes of the quantized data.
+
+    QuantBScaleCount - Receives the number of scales.
+
+    QuantBZeroPointSize - Receives the size in bytes of the zero points.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+    *QuantBDataSize = N * BlockCountK * ((BlkLen * BlkBitWidth + 7) / 8);
+    *QuantBScaleCount = N * BlockCountK;
+    *QuantBZeroPointSize = N * ((BlockCountK * BlkBitWidth + 7) / 8);
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+uint8_t
+MlasQNBitGetValue(
+    const uint8_t* Buffer,
+    size_t Index
+    )
+{
+    if constexpr (BlkBitWidth == 4) {
+        return (Buffer[Index / 2] >> ((Index & 1) * 4)) & 0x0F;
+    } else {
+        return Buffer[Index];
+    }
+}
+
+template<size_t BlkBitWidth>
+MLAS_FORCEINLINE
+void
+MlasQNBitSetValue(
+    uint8_t* Buffer,
+    size_t Index,
+    uint8_t Value
+    )
+{
+    if constexpr (BlkBitWidth == 4) {
+        const uint32_t Shift = uint32_t(Index & 1) * 4;
+        Buffer[Index / 2] = uint8_t((Buffer[Index / 2] & ~(0x0F << Shift)) | (Value << Shift));
+    } else {
+        Buffer[Index] = Value;
+    }
+}
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitDequantizeColumn(
+    size_t BlkLen,
+    size_t StartBlock,
+    size_t CountK,
+    const uint8_t* ColumnData,
+    const float* ColumnScale,
+    const uint8_t* ColumnZeroPoint,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes a range of rows of one column of matrix B.
+
+Arguments:
+
+    BlkLen - Supplies the number of quantized values in a block.
+
+    StartBlock - Supplies the index of the first block to dequantize.
+
+    CountK - Supplies the number of rows to dequantize.
+
+    ColumnData - Supplies the quantized data of the column.
+
+    ColumnScale - Supplies the scales of the column.
+
+    ColumnZeroPoint - Supplies the zero points of the column, else nullptr.
+
+    D - Supplies the address of the single precision output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr float DefaultZeroPoint = float(1 << (BlkBitWidth - 1));
+
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+
+    for (size_t k = 0; k < CountK; k += BlkLen) {
+
+        const size_t Block = StartBlock + k / BlkLen;
+        const size_t CountBlockK = std::min(CountK - k, BlkLen);
+
+        const float Scale = ColumnScale[Block];
+        const float ZeroPoint = (ColumnZeroPoint != nullptr) ?
+            float(MlasQNBitGetValue<BlkBitWidth>(ColumnZeroPoint, Block)) : DefaultZeroPoint;
+
+        const uint8_t* b = ColumnData + Block * BlkDataSize;
+        float* d = D + k;
+
+        if constexpr (BlkBitWidth == 4) {
+
+            size_t kk = 0;
+
+            for (; kk + 2 <= CountBlockK; kk += 2) {
+                const uint8_t Value = b[kk / 2];
+                d[kk] = (float(Value & 0x0F) - ZeroPoint) * Scale;
+                d[kk + 1] = (float(Value >> 4) - ZeroPoint) * Scale;
+            }
+
+            if (kk < CountBlockK) {
+                d[kk] = (float(b[kk / 2] & 0x0F) - ZeroPoint) * Scale;
+            }
+
+        } else {
+
+            for (size_t kk = 0; kk < CountBlockK; kk++) {
+                d[kk] = (float(b[kk]) - ZeroPoint) * Scale;
+            }
+        }
+    }
+}
+
+MLAS_FORCEINLINE
+float
+MlasQNBitDot(
+    const float* A,
+    const float* B,
+    size_t CountK
+    )
+{
+    MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+    while (CountK >= 8) {
+        Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(A), MlasLoadFloat32x4(B), Accumulator0);
+        Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(A + 4), MlasLoadFloat32x4(B + 4), Accumulator1);
+        A += 8;
+        B += 8;
+        CountK -= 8;
+    }
+
+    if (CountK >= 4) {
+        Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(A), MlasLoadFloat32x4(B), Accumulator0);
+        A += 4;
+        B += 4;
+        CountK -= 4;
+    }
+
+    float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+
+    for (size_t k = 0; k < CountK; k++) {
+        Sum += A[k] * B[k];
+    }
+
+    return Sum;
+}
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitGemmOperation(
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    size_t BlkLen,
+    const MLAS_QNBIT_GEMM_DATA_PARAMS* Data
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a segment of the blockwise quantized matrix/matrix
+    multiply operation.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column of the segment.
+
+    RangeCountN - Supplies the number of columns of the segment.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    BlkLen - Supplies the number of quantized values in a block.
+
+    Data - Supplies the data parameters of the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_QNBITGEMM_STRIDEN * MLAS_QNBITGEMM_STRIDEK], 64);
+
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ColumnDataSize = BlockCountK * (BlkLen * BlkBitWidth / 8);
+    const size_t ColumnZeroPointSize = (BlockCountK * BlkBitWidth + 7) / 8;
+
+    const float* A = Data->A;
+    const size_t lda = Data->lda;
+    const size_t ldc = Data->ldc;
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+
+    for (size_t n = RangeStartN; n < RangeStartN + RangeCountN; n += CountN) {
+
+        CountN = std::min(RangeStartN + RangeCountN - n, size_t(MLAS_QNBITGEMM_STRIDEN));
+
+        float* c = Data->C + n;
+
+        if (K == 0) {
+            for (size_t m = 0; m < M; m++) {
+                std::fill_n(c + m * ldc, CountN, 0.0f);
+            }
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. Each
+        // slice is dequantized to a transposed single precision block and
+        // accumulated into matrix C.
+        //
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_QNBITGEMM_STRIDEK));
+
+            for (size_t nn = 0; nn < CountN; nn++) {
+
+                const size_t Column = n + nn;
+                const uint8_t* ColumnZeroPoint = (Data->QuantBZeroPoint != nullptr) ?
+                    Data->QuantBZeroPoint + Column * ColumnZeroPointSize : nullptr;
+
+                MlasQNBitDequantizeColumn<BlkBitWidth>(BlkLen, k / BlkLen, CountK,
+                    Data->QuantBData + Column * ColumnDataSize,
+                    Data->QuantBScale + Column * BlockCountK, ColumnZeroPoint, PanelB + nn * CountK);
+            }
+
+            if (M <= MLAS_QNBITGEMM_GEMV_MAXIMUM_M) {
+
+                for (size_t m = 0; m < M; m++) {
+
+                    const float* a = A + m * lda + k;
+                    float* cm = c + m * ldc;
+
+                    for (size_t nn = 0; nn < CountN; nn++) {
+                        const float Sum = MlasQNBitDot(a, PanelB + nn * CountK, CountK);
+                        cm[nn] = (k == 0) ? Sum : cm[nn] + Sum;
+                    }
+                }
+
+            } else {
+
+                MlasSgemmOperation(CblasNoTrans, CblasTrans, M, CountN, CountK,
+                    1.0f, A + k, lda, PanelB, CountK, (k == 0) ? 0.0f : 1.0f, c, ldc);
+            }
+        }
+
+        if (Data->Bias != nullptr) {
+            for (size_t m = 0; m < M; m++) {
+                float* cm = c + m * ldc;
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    cm[nn] += Data->Bias[n + nn];
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQNBitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const MLAS_QNBIT_GEMM_DATA_PARAMS* Data,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across multiple threads along N only, so that
+    // every block of matrix B is dequantized by exactly one thread.
+    //
+
+    const size_t BlockedN = (N + MLAS_QNBITGEMM_STRIDEN - 1) / MLAS_QNBITGEMM_STRIDEN;
+
+    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchN - 1) / BatchN;
+
+    if (size_t(ThreadsPerGemm) > BlockedN) {
+        ThreadsPerGemm = ptrdiff_t(BlockedN);
+    }
+
+    if (ThreadsPerGemm == 0) {
+        ThreadsPerGemm = 1;
+    }
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchN),
+        [=](ptrdiff_t tid)
+    {
+        const ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
+        const ptrdiff_t ThreadIdN = tid % ThreadsPerGemm;
+
+        size_t RangeStartN;
+        size_t RangeCountN;
+
+        MlasPartitionWork(ThreadIdN, ThreadsPerGemm, BlockedN, &RangeStartN, &RangeCountN);
+
+        RangeStartN *= MLAS_QNBITGEMM_STRIDEN;
+        RangeCountN *= MLAS_QNBITGEMM_STRIDEN;
+
+        if (RangeStartN >= N) {
+            return;
+        }
+
+        RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+        if (BlkBitWidth == 4) {
+            MlasQNBitGemmOperation<4>(M, RangeStartN, RangeCountN, K, BlkLen, &Data[GemmIdx]);
+        } else {
+            MlasQNBitGemmOperation<8>(M, RangeStartN, RangeCountN, K, BlkLen, &Data[GemmIdx]);
+        }
+    });
+}
+
+template<size_t BlkBitWidth>
+void
+MlasQNBitQuantizeColumn(
+    size_t K,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    uint8_t* ColumnData,
+    float* ColumnScale,
+    uint8_t* ColumnZeroPoint
+    )
+{
+    constexpr int QuantMaximum = (1 << BlkBitWidth) - 1;
+    constexpr int DefaultZeroPoint = 1 << (BlkBitWidth - 1);
+
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+
+    for (size_t k = 0, Block = 0; k < K; k += BlkLen, Block++) {
+
+        const size_t CountBlockK = std::min(K - k, BlkLen);
+
+        float Scale;
+        int ZeroPoint;
+
+        if (ColumnZeroPoint != nullptr) {
+
+            //
+            // Asymmetric: map [min, max] including zero onto [0, QuantMaximum].
+            //
+
+            float Minimum = 0.0f;
+            float Maximum = 0.0f;
+
+            for (size_t kk = 0; kk < CountBlockK; kk++) {
+                Minimum = std::min(Minimum, B[(k + kk) * ldb]);
+                Maximum = std::max(Maximum, B[(k + kk) * ldb]);
+            }
+
+            Scale = (Maximum - Minimum) / QuantMaximum;
+            ZeroPoint = (Scale != 0.0f) ? int(std::nearbyint(-Minimum / Scale)) : DefaultZeroPoint;
+            ZeroPoint = std::min(std::max(ZeroPoint, 0), QuantMaximum);
+
+            MlasQNBitSetValue<BlkBitWidth>(ColumnZeroPoint, Block, uint8_t(ZeroPoint));
+
+        } else {
+
+            //
+            // Symmetric: the value of largest magnitude maps to zero so that
+            // the full range of the quantized values is used.
+            //
+
+            float AbsMaximum = 0.0f;
+
+            for (size_t kk = 0; kk < CountBlockK; kk++) {
+                if (std::fabs(B[(k + kk) * ldb]) > std::fabs(AbsMaximum)) {
+                    AbsMaximum = B[(k + kk) * ldb];
+                }
+            }
+
+            Scale = AbsMaximum / -DefaultZeroPoint;
+            ZeroPoint = DefaultZeroPoint;
+        }
+
+        const float ReciprocalScale = (Scale != 0.0f) ? 1.0f / Scale : 0.0f;
+
+        uint8_t* b = ColumnData + Block * BlkDataSize;
+        std::fill_n(b, BlkDataSize, uint8_t(0));
+
+        for (size_t kk = 0; kk < CountBlockK; kk++) {
+            int Value = int(std::nearbyint(B[(k + kk) * ldb] * ReciprocalScale)) + ZeroPoint;
+            Value = std::min(std::max(Value, 0), QuantMaximum);
+            MlasQNBitSetValue<BlkBitWidth>(b, kk, uint8_t(Value));
+        }
+
+        ColumnScale[Block] = Scale;
+    }
+}
+
+void
+MLASCALL
+MlasQNBitGemmQuantizeB(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* B,
+    size_t ldb,
+    uint8_t* QuantBData,
+    float* QuantBScale,
+    uint8_t* QuantBZeroPoint,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a row major matrix B to the blockwise format used
+    by MlasQNBitGemmBatch. The columns are quantized in parallel.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    BlkBitWidth - Supplies the number of bits of a quantized value.
+
+    BlkLen - Supplies the number of quantized values in a block.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    QuantBData - Supplies the buffer receiving the quantized data.
+
+    QuantBScale - Supplies the buffer receiving the scales.
+
+    QuantBZeroPoint - Supplies the buffer receiving the zero points, else
+        nullptr to quantize symmetrically.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ColumnDataSize = BlockCountK * (BlkLen * BlkBitWidth / 8);
+    const size_t ColumnZeroPointSize = (BlockCountK * BlkBitWidth + 7) / 8;
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(N), [&](ptrdiff_t tid) {
+
+        const size_t n = size_t(tid);
+
+        uint8_t* ColumnZeroPoint = nullptr;
+
+        if (QuantBZeroPoint != nullptr) {
+            ColumnZeroPoint = QuantBZeroPoint + n * ColumnZeroPointSize;
+            std::fill_n(ColumnZeroPoint, ColumnZeroPointSize, uint8_t(0));
+        }
+
+        if (BlkBitWidth == 4) {
+            MlasQNBitQuantizeColumn<4>(K, BlkLen, B + n, ldb, QuantBData + n * ColumnDataSize,
+                QuantBScale + n * BlockCountK, ColumnZeroPoint);
+        } else {
+            MlasQNBitQuantizeColumn<8>(K, BlkLen, B + n, ldb, QuantBData + n * ColumnDataSize,
+                QuantBScale + n * BlockCountK, ColumnZeroPoint);
+        }
+    });
+}
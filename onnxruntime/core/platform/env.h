@@ -122,6 +122,18 @@ class Env {
   // This function doesn't support systems with more than 64 logical processors
   virtual std::vector<size_t> GetThreadAffinityMasks() const = 0;
 
+  // Returns the logical processors of each NUMA node, in the same format as ThreadOptions::affinity.
+  // Returns an empty vector if the NUMA topology is not available.
+  virtual std::vector<std::vector<size_t>> GetNumaNodeThreadAffinityMasks() const { return {}; }
+
+  // Sets `numa_node` as the preferred node for the pages of [p, p + size) that haven't been touched yet.
+  // The pages partially covered by the range are included. No-op where not supported.
+  virtual void SetPreferredNumaNode(void* p, size_t size, int numa_node) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
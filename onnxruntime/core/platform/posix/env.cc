@@ -31,6 +31,11 @@ limitations under the License.
 #include <utility>  // for std::forward
 #include <vector>
 #include <assert.h>
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <fstream>
+#include <sstream>
+#include <sys/syscall.h>
+#endif
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -246,6 +251,57 @@ class PosixEnv : public Env {
     return ret;
   }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  std::vector<std::vector<size_t>> GetNumaNodeThreadAffinityMasks() const override {
+    std::vector<std::vector<size_t>> ret;
+    for (int node = 0;; ++node) {
+      // cpulist is a comma separated list of processor ranges, e.g. "0-15,32-47"
+      std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      if (!cpulist.good()) {
+        break;
+      }
+
+      std::vector<size_t> processors;
+      std::string range;
+      while (std::getline(cpulist, range, ',')) {
+        size_t first = 0;
+        size_t last = 0;
+        char dash = 0;
+        std::istringstream range_stream(range);
+        if (!(range_stream >> first)) {
+          continue;
+        }
+        last = (range_stream >> dash >> last) && dash == '-' ? last : first;
+        for (size_t processor = first; processor <= last; ++processor) {
+          processors.push_back(processor);
+        }
+      }
+
+      ret.push_back(std::move(processors));
+    }
+
+    return ret;
+  }
+
+  void SetPreferredNumaNode(void* p, size_t size, int numa_node) const override {
+    // mbind from <numaif.h> without the dependency on libnuma
+    constexpr int kMpolPreferred = 1;
+    if (p == nullptr || size == 0 || numa_node < 0 || numa_node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+      return;
+    }
+
+    const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(p) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(p) + size + page_size - 1) & ~(page_size - 1);
+    const unsigned long node_mask = 1UL << numa_node;
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, &node_mask, sizeof(node_mask) * 8, 0) != 0) {
+      auto [err_no, err_msg] = GetSystemError();
+      LOGS_DEFAULT(VERBOSE) << "mbind to NUMA node " << numa_node << " failed, error code: " << err_no
+                            << " error msg: " << err_msg;
+    }
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
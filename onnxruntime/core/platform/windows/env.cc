@@ -211,6 +211,31 @@ class WindowsEnv : public Env {
     return ret;
   }
 
+  std::vector<std::vector<size_t>> GetNumaNodeThreadAffinityMasks() const override {
+    // Only the processors of the first processor group are reported, in line with GetThreadAffinityMasks.
+    std::vector<std::vector<size_t>> ret;
+    ULONG highest_node = 0;
+    if (!GetNumaHighestNodeNumber(&highest_node)) {
+      return ret;
+    }
+
+    for (ULONG node = 0; node <= highest_node; ++node) {
+      ULONGLONG node_mask = 0;
+      std::vector<size_t> processors;
+      if (GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &node_mask)) {
+        for (size_t processor = 0; processor < 64; ++processor) {
+          if (node_mask & (1ULL << processor)) {
+            processors.push_back(static_cast<size_t>(1ULL << processor));
+          }
+        }
+      }
+
+      ret.push_back(std::move(processors));
+    }
+
+    return ret;
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
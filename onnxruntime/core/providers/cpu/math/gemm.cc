@@ -193,6 +193,28 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UsePersistedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                             std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                             /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                 /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (input_idx == 1) {
+    used_persisted_buffers = true;
+    b_shape_ = tensor.Shape();
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(T* y_data, size_t y_size, concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
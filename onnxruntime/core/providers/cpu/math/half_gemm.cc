@@ -0,0 +1,346 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/half_gemm.h"
+
+#include <unordered_map>
+
+#include "core/common/safeint.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    7,
+    8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfGemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    9,
+    10,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfGemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    Gemm,
+    11,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfGemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfGemm<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    HalfGemm<BFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1,
+    8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfMatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfMatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    HalfMatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    HalfMatMul<BFloat16>);
+
+namespace {
+
+template <typename T>
+struct MlasHalfTypeOf;
+
+template <>
+struct MlasHalfTypeOf<MLFloat16> {
+  static constexpr MLAS_HALF_TYPE value = MlasHalfTypeFp16;
+};
+
+template <>
+struct MlasHalfTypeOf<BFloat16> {
+  static constexpr MLAS_HALF_TYPE value = MlasHalfTypeBf16;
+};
+
+bool HalfGemmPackB(AllocatorPtr& alloc,
+                   const Tensor& tensor_b,
+                   bool trans_b,
+                   BufferUniquePtr& packed_b,
+                   size_t& packed_b_size,
+                   TensorShape& b_shape) {
+  // Only handle the common case of a 2D weight matrix.
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  packed_b_size = MlasHalfGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+
+  // Zero the alignment padding so the buffer hashes the same when it is shared or persisted.
+  memset(packed_b_data, 0, packed_b_size);
+
+  packed_b = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+  MlasHalfGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                    N,
+                    K,
+                    reinterpret_cast<const uint16_t*>(tensor_b.DataRaw()),
+                    trans_b ? K : N,
+                    packed_b_data);
+  return true;
+}
+
+}  // namespace
+
+template <typename T>
+Status HalfGemm<T>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B
+  if (input_idx == 1) {
+    size_t packed_b_size;
+    is_packed = HalfGemmPackB(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    if (is_packed && prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+    }
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfGemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfGemm<T>::UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                 /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (input_idx == 1) {
+    used_persisted_buffers = true;
+    b_shape_ = tensor.Shape();
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfGemm<T>::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const auto* A = context->Input<Tensor>(0);
+  const auto* B = packed_b_ ? nullptr : context->Input<Tensor>(1);
+  const auto* C = context->Input<Tensor>(2);
+
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(A->Shape(), trans_A_ != CblasNoTrans, B ? B->Shape() : b_shape_, trans_B_ != CblasNoTrans,
+                    C != nullptr ? C->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  auto* Y = context->Output(0, {helper.M(), helper.N()});
+
+  // if input is empty tensor, return as nothing need to be calculated and we've set the shape for the output
+  if (M == 0 || N == 0)
+    return Status::OK();
+
+  auto* y_data = reinterpret_cast<uint16_t*>(Y->MutableDataRaw());
+  const auto* c_data = C != nullptr ? reinterpret_cast<const uint16_t*>(C->DataRaw()) : nullptr;
+  const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
+
+  // The bias is copied as 16-bit values and scaled by beta in the GEMM.
+  GemmBroadcastBias(helper.M(), helper.N(), beta_, c_data, c_shape, y_data);
+
+  BufferUniquePtr packed_b_buffer;
+  const void* packed_b = packed_b_.get();
+
+  if (B) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    packed_b_buffer = BufferUniquePtr(alloc->Alloc(MlasHalfGemmPackBSize(N, K)), BufferDeleter(alloc));
+    MlasHalfGemmPackB(trans_B_, N, K, reinterpret_cast<const uint16_t*>(B->DataRaw()),
+                      trans_B_ != CblasNoTrans ? K : N, packed_b_buffer.get());
+    packed_b = packed_b_buffer.get();
+  }
+
+  MLAS_HALF_GEMM_DATA_PARAMS data;
+  data.A = reinterpret_cast<const uint16_t*>(A->DataRaw());
+  data.lda = trans_A_ != CblasNoTrans ? M : K;
+  data.PackedB = packed_b;
+  data.C = y_data;
+  data.ldc = N;
+  data.alpha = alpha_;
+  data.beta = c_data != nullptr ? beta_ : 0.0f;
+
+  MlasHalfGemmBatch(MlasHalfTypeOf<T>::value, trans_A_, M, N, K, &data, 1, thread_pool);
+
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfMatMul<T>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                              /*out*/ bool& is_packed,
+                              /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B
+  if (input_idx == 1) {
+    size_t packed_b_size;
+    is_packed = HalfGemmPackB(alloc, tensor, false, packed_b_, packed_b_size, b_shape_);
+    if (is_packed && prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+    }
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfMatMul<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                                /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfMatMul<T>::UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (input_idx == 1) {
+    used_persisted_buffers = true;
+    b_shape_ = tensor.Shape();
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status HalfMatMul<T>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  const auto& b_shape = b ? b->Shape() : b_shape_;
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = reinterpret_cast<const uint16_t*>(a->DataRaw());
+  auto* y_data = reinterpret_cast<uint16_t*>(y->MutableDataRaw());
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  // Pack B if it isn't a pre-packed initializer. With broadcasting the same matrix of B can be used by several
+  // outputs, so each distinct matrix is packed once.
+  BufferUniquePtr packed_b_buffer;
+  std::vector<const void*> packed_b(max_len, packed_b_.get());
+
+  if (b) {
+    std::unordered_map<size_t, size_t> packed_b_index;
+    for (size_t i = 0; i < max_len; i++) {
+      packed_b_index.emplace(helper.RightOffsets()[i], packed_b_index.size());
+    }
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    const size_t packed_b_size = MlasHalfGemmPackBSize(N, K);
+    packed_b_buffer = BufferUniquePtr(alloc->Alloc(SafeInt<size_t>(packed_b_size) * packed_b_index.size()),
+                                      BufferDeleter(alloc));
+    auto* packed_b_data = static_cast<uint8_t*>(packed_b_buffer.get());
+
+    const auto* b_data = reinterpret_cast<const uint16_t*>(b->DataRaw());
+    for (const auto& entry : packed_b_index) {
+      MlasHalfGemmPackB(CblasNoTrans, N, K, b_data + entry.first, N, packed_b_data + entry.second * packed_b_size);
+    }
+
+    for (size_t i = 0; i < max_len; i++) {
+      packed_b[i] = packed_b_data + packed_b_index[helper.RightOffsets()[i]] * packed_b_size;
+    }
+  }
+
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].PackedB = packed_b[i];
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasHalfGemmBatch(MlasHalfTypeOf<T>::value, CblasNoTrans, M, N, K, data.data(), max_len, thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -157,6 +157,20 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (input_idx == 1) {
+    used_persisted_buffers = true;
+    b_shape_ = tensor.Shape();
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <optional>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/lookup_table.h"
 #include "core/providers/cpu/ml/ml_common.h"
 
 namespace onnxruntime {
@@ -22,27 +25,15 @@ class CategoryMapper final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_categories.size();
-
-    ORT_ENFORCE(num_entries == int_categories.size());
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_categories[i];
-      int64_t index = int_categories[i];
-
-      string_to_int_map_[str] = index;
-      int_to_string_map_[index] = str;
-    }
+    string_to_int_map_.emplace(string_categories, int_categories);
+    int_to_string_map_.emplace(int_categories, string_categories);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  std::optional<LookupTable<std::string, int64_t>> string_to_int_map_;
+  std::optional<LookupTable<int64_t, std::string>> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <numeric>
+#include <optional>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/lookup_table.h"
 #include "core/providers/cpu/ml/ml_common.h"
 
 namespace onnxruntime {
@@ -13,31 +17,22 @@ namespace ml {
 class LabelEncoder final : public OpKernel {
  public:
   LabelEncoder(const OpKernelInfo& info) : OpKernel(info) {
-    std::vector<std::string> string_classes;
-
-    ORT_ENFORCE(info.GetAttrs<std::string>("classes_strings", string_classes).IsOK());
+    ORT_ENFORCE(info.GetAttrs<std::string>("classes_strings", classes_).IsOK());
 
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
-
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
-    }
+    std::vector<int64_t> indices(classes_.size());
+    std::iota(indices.begin(), indices.end(), int64_t{0});
+    string_to_int_map_.emplace(classes_, indices);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  // Class labels by index, which is all the int64 to string direction needs.
+  std::vector<std::string> classes_;
+  std::optional<LookupTable<std::string, int64_t>> string_to_int_map_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -64,8 +59,7 @@ class LabelEncoder_2 final : public OpKernel {
                 "However, the number of key is ", num_keys, " and the number of ",
                 "values is ", num_values, ".");
 
-    for (size_t i = 0; i < num_keys; ++i)
-      _map[keys[i]] = values[i];
+    _map.emplace(keys, values);
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -75,16 +69,8 @@ class LabelEncoder_2 final : public OpKernel {
     const TensorShape& shape = X.Shape();
     Tensor& Y = *context->Output(0, shape);
 
-    auto input = X.template DataAsSpan<TKey>();
-    auto output = Y.template MutableDataAsSpan<TValue>();
-
-    for (int64_t i = 0; i < shape.Size(); ++i) {
-      const auto found = _map.find(input[i]);
-      if (found == _map.end())
-        output[i] = _default_value;
-      else
-        output[i] = found->second;
-    }
+    LookupBatch(context->GetOperatorThreadPool(), *_map,
+                X.template DataAsSpan<TKey>(), Y.template MutableDataAsSpan<TValue>(), _default_value);
 
     return Status::OK();
   }
@@ -98,7 +84,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If _map doesn't contain "a_key", we use _default_value as its output.
-  std::unordered_map<TKey, TValue> _map;
+  std::optional<LookupTable<TKey, TValue>> _map;
   TValue _default_value;
   // ONNX attribute name to load keys.
   std::string _key_field_name;
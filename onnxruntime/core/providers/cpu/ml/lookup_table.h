@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "gsl/gsl"
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Immutable key to value table built once when a kernel is constructed. It is an open addressing hash table, so a
+// lookup probes a single contiguous array instead of chasing the per-node allocations of std::unordered_map.
+// If a key is repeated, the last value wins.
+template <typename TKey, typename TValue>
+class LookupTable {
+ public:
+  LookupTable(gsl::span<const TKey> keys, gsl::span<const TValue> values) {
+    ORT_ENFORCE(keys.size() == values.size(), "Number of keys (", keys.size(), ") and values (", values.size(),
+                ") must be the same.");
+
+    map_.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      map_.insert_or_assign(keys[i], values[i]);
+    }
+  }
+
+  // Returns nullptr if the key is not in the table.
+  const TValue* Find(const TKey& key) const {
+    auto found = map_.find(key);
+    return found == map_.end() ? nullptr : &found->second;
+  }
+
+  size_t Size() const { return map_.size(); }
+
+ private:
+  InlinedHashMap<TKey, TValue> map_;
+};
+
+// String keys are copied into one arena so that the table holds views of them, which keeps the slots small and the
+// key bytes adjacent in memory. Lookups hash the input string directly without creating a std::string.
+template <typename TValue>
+class LookupTable<std::string, TValue> {
+ public:
+  LookupTable(gsl::span<const std::string> keys, gsl::span<const TValue> values) {
+    ORT_ENFORCE(keys.size() == values.size(), "Number of keys (", keys.size(), ") and values (", values.size(),
+                ") must be the same.");
+
+    size_t arena_size = 0;
+    for (const auto& key : keys) {
+      arena_size += key.size();
+    }
+
+    // the arena must not reallocate once views of it have been taken
+    arena_.reserve(arena_size);
+    for (const auto& key : keys) {
+      arena_.append(key);
+    }
+
+    map_.reserve(keys.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      map_.insert_or_assign(std::string_view(arena_.data() + offset, keys[i].size()), values[i]);
+      offset += keys[i].size();
+    }
+  }
+
+  LookupTable(const LookupTable&) = delete;
+  LookupTable& operator=(const LookupTable&) = delete;
+
+  // Returns nullptr if the key is not in the table.
+  const TValue* Find(std::string_view key) const {
+    auto found = map_.find(key);
+    return found == map_.end() ? nullptr : &found->second;
+  }
+
+  size_t Size() const { return map_.size(); }
+
+ private:
+  std::string arena_;
+  InlinedHashMap<std::string_view, TValue> map_;
+};
+
+// Maps every input element with the table, writing default_value for the ones that are not in it.
+// The elements are independent so the work is split across the thread pool for large inputs.
+template <typename TKey, typename TValue>
+void LookupBatch(concurrency::ThreadPool* thread_pool, const LookupTable<TKey, TValue>& table,
+                 gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value) {
+  // a hash of the key plus a probe that usually hits in the first group
+  constexpr double kLookupCycles = 40.0;
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)), kLookupCycles},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const TValue* value = table.Find(input[i]);
+          output[i] = value == nullptr ? default_value : *value;
+        }
+      });
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
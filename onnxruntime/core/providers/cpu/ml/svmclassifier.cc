@@ -74,6 +74,31 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   ORT_ENFORCE(coefficients_.size() > 0);
   weights_are_all_positive_ = std::all_of(coefficients_.cbegin(), coefficients_.cend(),
                                           [](float value) { return value >= 0.f; });
+
+  // Each classifier only uses the coefficients of the support vectors of its two classes. With few classes a dense
+  // matrix of them is mostly non-zero, so the classifier scores for a batch are computed with a single GEMM.
+  constexpr int64_t kMaxClassesForDecisionGemm = 16;
+  if (mode_ == SVM_TYPE::SVM_SVC && class_count_ > 1 && class_count_ <= kMaxClassesForDecisionGemm &&
+      static_cast<int64_t>(vectors_per_class_.size()) == class_count_ &&
+      static_cast<int64_t>(coefficients_.size()) >= vector_count_ * (class_count_ - 1)) {
+    const int64_t num_classifiers = class_count_ * (class_count_ - 1) / 2;
+    decision_coefficients_.resize(SafeInt<size_t>(vector_count_) * num_classifiers, 0.f);
+
+    int64_t classifier_idx = 0;
+    for (int64_t i = 0; i < class_count_ - 1; i++) {
+      for (int64_t j = i + 1; j < class_count_; j++, classifier_idx++) {
+        // see ComputeImpl for the layout of the coefficients
+        for (int64_t m = 0; m < vectors_per_class_[i]; m++) {
+          const int64_t v = starting_vector_[i] + m;
+          decision_coefficients_[v * num_classifiers + classifier_idx] = coefficients_[vector_count_ * (j - 1) + v];
+        }
+        for (int64_t m = 0; m < vectors_per_class_[j]; m++) {
+          const int64_t v = starting_vector_[j] + m;
+          decision_coefficients_[v * num_classifiers + classifier_idx] = coefficients_[vector_count_ * i + v];
+        }
+      }
+    }
+  }
 }
 
 template <typename LabelType>
@@ -247,7 +272,17 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
                               threadpool);
 
-    for (int64_t n = 0; n < num_batches; n++) {
+    if (!decision_coefficients_.empty()) {
+      // scores for every classifier of every batch, before adding rho
+      MlasGemm(CblasNoTrans, CblasNoTrans,
+               static_cast<size_t>(num_batches), static_cast<size_t>(num_classifiers), static_cast<size_t>(vector_count_),
+               1.f, kernels_data.data(), static_cast<size_t>(vector_count_),
+               decision_coefficients_.data(), static_cast<size_t>(num_classifiers),
+               0.f, classifier_scores.data(), static_cast<size_t>(num_slots_per_iteration),
+               threadpool);
+    }
+
+    auto score_batch = [&](ptrdiff_t n) {
       // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
       // per class.
       // coefficients: [num_classes - 1, vector_count_]
@@ -274,6 +309,18 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
       auto cur_votes = votes_span.subspan(n * class_count_, class_count_);
       auto scores_iter = cur_scores.begin();
 
+      if (!decision_coefficients_.empty()) {
+        int64_t classifier_idx = 0;
+        for (int64_t i = 0; i < class_count_ - 1; i++) {
+          for (int64_t j = i + 1; j < class_count_; j++) {
+            const float sum = *scores_iter + rho_[classifier_idx++];
+            *scores_iter++ = sum;
+            ++(cur_votes[sum > 0 ? i : j]);
+          }
+        }
+        return;
+      }
+
       int64_t classifier_idx = 0;
       for (int64_t i = 0; i < class_count_ - 1; i++) {
         int64_t start_index_i = starting_vector_[i];  // start of support vectors for class i
@@ -304,6 +351,15 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
           ++(cur_votes[sum > 0 ? i : j]);
         }
       }
+    };
+
+    // same threshold as finalize_batch below
+    if (num_batches > 512) {
+      concurrency::ThreadPool::TryBatchParallelFor(threadpool, num_batches, score_batch, -1);
+    } else {
+      for (ptrdiff_t i = 0; i < num_batches; ++i) {
+        score_batch(i);
+      }
     }
   }
 
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
 #include "core/providers/cpu/math/gemm.h"
@@ -39,28 +40,27 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
+      // ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a.b, and the a.b terms for all the pairs are a single GEMM
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
 
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
+      const auto a_norms = ConstEigenMatrixMapRowMajor<T>(a.data(), m, k).rowwise().squaredNorm().eval();
+      const auto b_norms = ConstEigenMatrixMapRowMajor<T>(b.data(), n, k).rowwise().squaredNorm().eval();
 
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
+      T* cur_out = out.data();
+      for (int64_t batch = 0; batch < m; ++batch) {
         for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
+          // rounding can make the distance of (nearly) equal vectors slightly negative
+          T sum = std::max(*cur_out + a_norms[batch] + b_norms[support_vector], T(0));
+          *cur_out++ = -gamma_ * sum;
         }
-
-        cur_batch += k;  // move to start of next batch
       }
+
+      MlasComputeExp(out.data(), out.data(), out.size());
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -126,6 +126,8 @@ class SVMClassifier final : public OpKernel, private SVMCommon {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  // [vector_count_, num_classifiers] coefficients of each classifier, zero for the support vectors of other classes
+  std::vector<float> decision_coefficients_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -83,6 +83,21 @@ struct TreeNodeElement {
   bool is_missing_track_true;
 };
 
+// Flattened layout of the tree nodes (see TreeEnsembleCommon::InitFlatLayout).
+// A child index with kFlatTreeLeafBit set refers to the array of leaves, otherwise to the array of nodes.
+// A feature id with kFlatTreeMissingTrackTrueBit set sends missing values to the true branch.
+constexpr uint32_t kFlatTreeLeafBit = 0x80000000u;
+constexpr uint32_t kFlatTreeMissingTrackTrueBit = 0x80000000u;
+
+// 16 bytes when T is float, so 4 nodes share a cache line.
+template <typename T>
+struct FlatTreeNodeElement {
+  uint32_t feature_id;
+  T value;
+  uint32_t truenode;
+  uint32_t falsenode;
+};
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 class TreeAggregator {
  protected:
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -12,6 +14,26 @@ namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// How the trees are evaluated. kDefault lets Init() choose, the others force an engine so tests can cover each one:
+// kNodes walks the linked nodes, kFlat the flattened layout and kQuickScorer uses QuickScorer for any batch size.
+// An engine the ensemble does not qualify for falls back to the default choice.
+enum class TreeEnsembleEngine {
+  kDefault,
+  kNodes,
+  kFlat,
+  kQuickScorer,
+};
+
+// For tests only. The engine used by the tree ensembles initialized afterwards.
+inline std::atomic<TreeEnsembleEngine>& TreeEnsembleEngineForTesting() {
+  static std::atomic<TreeEnsembleEngine> engine{TreeEnsembleEngine::kDefault};
+  return engine;
+}
+
+// Number of rows walked together through a tree when several rows are evaluated.
+// Their node lookups are independent, so the memory latency of one row overlaps with the others.
+constexpr int64_t kTreeEnsembleRowBlockSize = 16;
+
 class TreeEnsembleCommonAttributes {
  public:
   int64_t get_target_or_class_count() const { return this->n_targets_or_classes_; }
@@ -42,6 +64,29 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<TreeNodeElement<ThresholdType>> nodes_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // Flattened layout of the trees, built by InitFlatLayout and used instead of roots_ when use_flat_layout_ is true.
+  bool use_flat_layout_;
+  NODE_MODE flat_mode_;
+  std::vector<FlatTreeNodeElement<ThresholdType>> flat_nodes_;
+  std::vector<const TreeNodeElement<ThresholdType>*> flat_leaves_;
+  std::vector<uint32_t> flat_roots_;
+
+  // QuickScorer representation of the trees, built by InitQuickScorer and used instead of a tree traversal when
+  // use_quick_scorer_ is true. The branch nodes of all trees are sorted by feature and threshold: entries
+  // [qs_feature_offsets_[f], qs_feature_offsets_[f + 1]) hold the nodes testing feature f by increasing threshold.
+  // Each entry holds the mask clearing the leaves of its true subtree in its tree's leaf bitvector.
+  // QuickScorer only splits the work by rows, so by default it is only used for batches with more than parallel_N_
+  // rows and smaller ones keep the paths that parallelize over the trees. force_quick_scorer_ uses it for all.
+  bool use_quick_scorer_;
+  bool force_quick_scorer_;
+  std::vector<size_t> qs_feature_offsets_;
+  std::vector<ThresholdType> qs_thresholds_;
+  std::vector<uint8_t> qs_strict_;  // 1 for BRANCH_LT, 0 for BRANCH_LEQ
+  std::vector<uint32_t> qs_tree_ids_;
+  std::vector<uint64_t> qs_masks_;
+  std::vector<size_t> qs_leaf_offsets_;  // leaves of tree j start at qs_leaves_[qs_leaf_offsets_[j]]
+  std::vector<const TreeNodeElement<ThresholdType>*> qs_leaves_;
+
  public:
   TreeEnsembleCommon() {}
 
@@ -76,6 +121,33 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
 
+  const TreeNodeElement<ThresholdType>* ProcessFlatTreeNodeLeave(uint32_t index, const InputType* x_data) const;
+
+  // Returns the leaf reached by x_data in tree tree_index using the layout chosen by Init.
+  const TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(size_t tree_index, const InputType* x_data) const {
+    return use_flat_layout_ ? ProcessFlatTreeNodeLeave(flat_roots_[tree_index], x_data)
+                            : ProcessTreeNodeLeave(roots_[tree_index], x_data);
+  }
+
+  // Computes the leaves reached by n_rows (at most kTreeEnsembleRowBlockSize) consecutive rows in tree tree_index.
+  void ProcessTreeNodeLeaves(size_t tree_index, const InputType* x_data, int64_t stride, int64_t n_rows,
+                             const TreeNodeElement<ThresholdType>** leaves) const;
+
+  // Builds the QuickScorer representation. Returns false unless every tree has at most 64 leaves, all branch
+  // nodes use BRANCH_LEQ or BRANCH_LT, and no node tracks missing values.
+  bool InitQuickScorer();
+
+  // Fills leaf_bits with the leaf bitvector of every tree for one row.
+  void ProcessQuickScorer(const InputType* x_data, uint64_t* leaf_bits) const;
+
+  template <typename AGG>
+  void ComputeAggQuickScorer(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label,
+                             const AGG& agg) const;
+
+  // Builds the flattened layout: 16-byte nodes (for float thresholds) stored breadth-first per tree, children
+  // referred to by index and leaves kept in a separate array. Returns false if the ensemble cannot use it.
+  bool InitFlatLayout();
+
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 };
@@ -297,9 +369,246 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(int parall
       break;
     }
   }
+
+  const TreeEnsembleEngine engine = TreeEnsembleEngineForTesting().load();
+  use_flat_layout_ = engine != TreeEnsembleEngine::kNodes && InitFlatLayout();
+  use_quick_scorer_ = (engine == TreeEnsembleEngine::kDefault || engine == TreeEnsembleEngine::kQuickScorer) &&
+                      InitQuickScorer();
+  force_quick_scorer_ = use_quick_scorer_ && engine == TreeEnsembleEngine::kQuickScorer;
   return Status::OK();
 }
 
+struct QuickScorerNode {
+  int64_t feature_id;
+  size_t node;  // index of the branch node
+  uint32_t tree_id;
+  uint64_t mask;
+};
+
+// Mask with the bits [first, last) cleared.
+inline uint64_t QuickScorerMask(uint32_t first, uint32_t last) {
+  const uint32_t count = last - first;
+  const uint64_t bits = count >= 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+  return ~(bits << first);
+}
+
+// Index of the lowest bit set.
+inline uint32_t QuickScorerLowestBit(uint64_t bits) {
+#if defined(__GNUC__)
+  return static_cast<uint32_t>(__builtin_ctzll(bits));
+#else
+  uint32_t index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitQuickScorer() {
+  qs_feature_offsets_.clear();
+  qs_thresholds_.clear();
+  qs_strict_.clear();
+  qs_tree_ids_.clear();
+  qs_masks_.clear();
+  qs_leaf_offsets_.clear();
+  qs_leaves_.clear();
+
+  if (has_missing_tracks_) {
+    return false;
+  }
+
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf &&
+        ((node.mode != NODE_MODE::BRANCH_LEQ && node.mode != NODE_MODE::BRANCH_LT) ||
+         node.value != node.value)) {  // NaN thresholds cannot be sorted
+      return false;
+    }
+  }
+
+  // Leaves are numbered in depth-first order, true branch first. Every node whose condition is false removes
+  // the leaves of its true subtree, and the exit leaf is the lowest leaf left.
+  struct StackItem {
+    const TreeNodeElement<ThresholdType>* node;
+    size_t entry;  // entry of the parent whose true subtree ends after this node, or SIZE_MAX
+  };
+
+  std::vector<QuickScorerNode> entries;
+  std::vector<uint32_t> first_leaves;  // first leaf of the true subtree of each entry
+  std::vector<StackItem> stack;
+  int64_t n_features = 0;
+
+  qs_leaf_offsets_.reserve(roots_.size());
+  for (size_t tree = 0; tree < roots_.size(); ++tree) {
+    qs_leaf_offsets_.push_back(qs_leaves_.size());
+    uint32_t n_leaves = 0;
+    size_t n_visited = 0;
+
+    stack.clear();
+    stack.push_back({roots_[tree], SIZE_MAX});
+    while (!stack.empty()) {
+      StackItem item = stack.back();
+      stack.pop_back();
+
+      if (item.node == nullptr || ++n_visited > static_cast<size_t>(n_nodes_)) {
+        return false;
+      }
+
+      if (item.entry != SIZE_MAX) {
+        // the true subtree of the entry is complete once its false child is reached
+        entries[item.entry].mask = QuickScorerMask(first_leaves[item.entry], n_leaves);
+      }
+
+      if (!item.node->is_not_leaf) {
+        if (n_leaves == 64) {
+          return false;
+        }
+        qs_leaves_.push_back(item.node);
+        ++n_leaves;
+        continue;
+      }
+
+      if (item.node->feature_id < 0) {
+        return false;
+      }
+      n_features = std::max(n_features, static_cast<int64_t>(item.node->feature_id) + 1);
+
+      entries.push_back({item.node->feature_id, static_cast<size_t>(item.node - nodes_.data()),
+                         static_cast<uint32_t>(tree), 0});
+      first_leaves.push_back(n_leaves);
+
+      stack.push_back({item.node->falsenode, entries.size() - 1});
+      stack.push_back({item.node->truenode, SIZE_MAX});
+    }
+  }
+
+  // Within a feature, the nodes whose condition is false for a value x form a prefix when sorted by threshold,
+  // with BRANCH_LT first on ties: x < t is false for t <= x and x <= t is false for t < x.
+  std::sort(entries.begin(), entries.end(), [this](const QuickScorerNode& a, const QuickScorerNode& b) {
+    const TreeNodeElement<ThresholdType>& na = nodes_[a.node];
+    const TreeNodeElement<ThresholdType>& nb = nodes_[b.node];
+    if (a.feature_id != b.feature_id)
+      return a.feature_id < b.feature_id;
+    if (na.value != nb.value)
+      return na.value < nb.value;
+    return na.mode == NODE_MODE::BRANCH_LT && nb.mode != NODE_MODE::BRANCH_LT;
+  });
+
+  qs_feature_offsets_.assign(static_cast<size_t>(n_features) + 1, 0);
+  qs_thresholds_.reserve(entries.size());
+  qs_strict_.reserve(entries.size());
+  qs_tree_ids_.reserve(entries.size());
+  qs_masks_.reserve(entries.size());
+  for (const auto& entry : entries) {
+    const TreeNodeElement<ThresholdType>& node = nodes_[entry.node];
+    ++qs_feature_offsets_[static_cast<size_t>(entry.feature_id) + 1];
+    qs_thresholds_.push_back(node.value);
+    qs_strict_.push_back(node.mode == NODE_MODE::BRANCH_LT ? 1 : 0);
+    qs_tree_ids_.push_back(entry.tree_id);
+    qs_masks_.push_back(entry.mask);
+  }
+  for (size_t f = 1; f < qs_feature_offsets_.size(); ++f) {
+    qs_feature_offsets_[f] += qs_feature_offsets_[f - 1];
+  }
+
+  return true;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessQuickScorer(const InputType* x_data,
+                                                                                 uint64_t* leaf_bits) const {
+  std::fill_n(leaf_bits, n_trees_, ~uint64_t(0));
+  for (size_t f = 0, n_features = qs_feature_offsets_.size() - 1; f < n_features; ++f) {
+    const InputType val = x_data[f];
+    for (size_t k = qs_feature_offsets_[f], end = qs_feature_offsets_[f + 1]; k < end; ++k) {
+      if (qs_strict_[k] ? val < qs_thresholds_[k] : val <= qs_thresholds_[k]) {
+        // the conditions of the remaining nodes are true as well
+        break;
+      }
+      leaf_bits[qs_tree_ids_[k]] &= qs_masks_[k];
+    }
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitFlatLayout() {
+  flat_nodes_.clear();
+  flat_leaves_.clear();
+  flat_roots_.clear();
+
+  // The flattened nodes do not store their mode, so all of them have to share the same one.
+  if (!same_mode_ || n_nodes_ >= static_cast<int64_t>(kFlatTreeLeafBit)) {
+    return false;
+  }
+
+  flat_mode_ = NODE_MODE::BRANCH_LEQ;
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf) {
+      flat_mode_ = node.mode;
+      break;
+    }
+  }
+
+  flat_nodes_.reserve(n_nodes_);
+  flat_roots_.reserve(roots_.size());
+
+  std::vector<const TreeNodeElement<ThresholdType>*> queue;
+  size_t n_visited = 0;
+  bool valid = true;
+
+  // Returns the index of a node in the flattened layout. Branch nodes are queued to be filled in later.
+  auto add_node = [&](const TreeNodeElement<ThresholdType>* node) -> uint32_t {
+    ++n_visited;
+    if (!node->is_not_leaf) {
+      flat_leaves_.push_back(node);
+      return static_cast<uint32_t>(flat_leaves_.size() - 1) | kFlatTreeLeafBit;
+    }
+
+    if (node->feature_id < 0 || static_cast<uint32_t>(node->feature_id) >= kFlatTreeMissingTrackTrueBit ||
+        node->truenode == nullptr || node->falsenode == nullptr) {
+      valid = false;
+    }
+
+    queue.push_back(node);
+    flat_nodes_.push_back({0, 0, 0, 0});
+    return static_cast<uint32_t>(flat_nodes_.size() - 1);
+  };
+
+  for (const auto* root : roots_) {
+    queue.clear();
+    size_t next_index = flat_nodes_.size();
+    flat_roots_.push_back(add_node(root));
+
+    // Breadth-first order keeps the top levels of a tree, which every row goes through, in a few cache lines.
+    for (size_t head = 0; head < queue.size() && valid; ++head, ++next_index) {
+      const TreeNodeElement<ThresholdType>* node = queue[head];
+      FlatTreeNodeElement<ThresholdType> flat_node;
+      flat_node.feature_id = static_cast<uint32_t>(node->feature_id) |
+                             (node->is_missing_track_true ? kFlatTreeMissingTrackTrueBit : 0);
+      flat_node.value = node->value;
+      flat_node.truenode = add_node(node->truenode);
+      flat_node.falsenode = add_node(node->falsenode);
+      flat_nodes_[next_index] = flat_node;
+
+      // a node reachable from more than one parent would be duplicated, give up on malformed trees
+      if (n_visited > static_cast<size_t>(n_nodes_)) {
+        valid = false;
+      }
+    }
+
+    if (!valid) {
+      flat_nodes_.clear();
+      flat_leaves_.clear();
+      flat_roots_.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKernelContext* ctx,
                                                                          const Tensor* X,
@@ -346,6 +655,11 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                                                           Tensor* label, const AGG& agg) const {
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
+
+  if (use_quick_scorer_ && (force_quick_scorer_ || N > parallel_N_)) {
+    ComputeAggQuickScorer(ttp, X, Z, label, agg);
+    return;
+  }
   OutputType* z_data = Z->template MutableData<OutputType>();
 
   const InputType* x_data = X->template Data<InputType>();
@@ -357,7 +671,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       ScoreValue<ThresholdType> score = {0, 0};
       if (n_trees_ <= parallel_tree_) { /* section A: 1 output, 1 row and not enough trees to parallelize */
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(j, x_data));
         }
       } else { /* section B: 1 output, 1 row and enough trees to parallelize */
         std::vector<ScoreValue<ThresholdType>> scores(n_trees_, {0, 0});
@@ -365,7 +679,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             ttp,
             SafeInt<int32_t>(n_trees_),
             [this, &scores, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(roots_[j], x_data));
+              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(j, x_data));
             },
             0);
 
@@ -375,17 +689,23 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       }
       agg.FinalizeScores1(z_data, score, label_data);
     } else if (N <= parallel_N_) { /* section C: 1 output, 2+ rows but not enough rows to parallelize */
-      ScoreValue<ThresholdType> score;
-      size_t j;
+      ScoreValue<ThresholdType> scores[kTreeEnsembleRowBlockSize];
+      const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
 
-      for (int64_t i = 0; i < N; ++i) {
-        score = {0, 0};
-        for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+      for (int64_t i = 0; i < N; i += kTreeEnsembleRowBlockSize) {
+        const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, N - i);
+        std::fill_n(scores, n_rows, ScoreValue<ThresholdType>({0, 0}));
+        for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+          ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction1(scores[r], *leaves[r]);
+          }
         }
 
-        agg.FinalizeScores1(z_data + i, score,
-                            label_data == nullptr ? nullptr : (label_data + i));
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores1(z_data + i + r, scores[r],
+                              label_data == nullptr ? nullptr : (label_data + i + r));
+        }
       }
     } else if (n_trees_ > max_num_threads) { /* section D: 1 output, 2+ rows and enough trees to parallelize */
       auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
@@ -395,13 +715,17 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           num_threads,
           [this, &agg, &scores, num_threads, x_data, N, stride](ptrdiff_t batch_num) {
             auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, this->n_trees_);
+            const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
             for (int64_t i = 0; i < N; ++i) {
               scores[batch_num * N + i] = {0, 0};
             }
             for (auto j = work.start; j < work.end; ++j) {
-              for (int64_t i = 0; i < N; ++i) {
-                agg.ProcessTreeNodePrediction1(scores[batch_num * N + i],
-                                               *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+              for (int64_t i = 0; i < N; i += kTreeEnsembleRowBlockSize) {
+                const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, N - i);
+                ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+                for (int64_t r = 0; r < n_rows; ++r) {
+                  agg.ProcessTreeNodePrediction1(scores[batch_num * N + i + r], *leaves[r]);
+                }
               }
             }
           });
@@ -419,18 +743,28 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                   label_data == nullptr ? nullptr : (label_data + i));
             }
           });
-    } else { /* section E: 1 output, 2+ rows, parallelization by rows */
+    } else { /* section E: 1 output, 2+ rows, parallelization by blocks of rows */
+      const int64_t n_blocks = (N + kTreeEnsembleRowBlockSize - 1) / kTreeEnsembleRowBlockSize;
       concurrency::ThreadPool::TryBatchParallelFor(
           ttp,
-          SafeInt<int32_t>(N),
-          [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-            ScoreValue<ThresholdType> score = {0, 0};
+          SafeInt<int32_t>(n_blocks),
+          [this, &agg, x_data, z_data, stride, label_data, N](ptrdiff_t block) {
+            ScoreValue<ThresholdType> scores[kTreeEnsembleRowBlockSize];
+            const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
+            const int64_t i = block * kTreeEnsembleRowBlockSize;
+            const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, N - i);
+            std::fill_n(scores, n_rows, ScoreValue<ThresholdType>({0, 0}));
             for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+              ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+              for (int64_t r = 0; r < n_rows; ++r) {
+                agg.ProcessTreeNodePrediction1(scores[r], *leaves[r]);
+              }
             }
 
-            agg.FinalizeScores1(z_data + i, score,
-                                label_data == nullptr ? nullptr : (label_data + i));
+            for (int64_t r = 0; r < n_rows; ++r) {
+              agg.FinalizeScores1(z_data + i + r, scores[r],
+                                  label_data == nullptr ? nullptr : (label_data + i + r));
+            }
           },
           0);
     }
@@ -439,7 +773,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       if (n_trees_ <= parallel_tree_) { /* section A2 */
         InlinedVector<ScoreValue<ThresholdType>> scores(n_targets_or_classes_, {0, 0});
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data));
+          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(j, x_data));
         }
         agg.FinalizeScores(scores, z_data, -1, label_data);
       } else { /* section B2: 2+ outputs, 1 row, enough trees to parallelize */
@@ -452,7 +786,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
               scores[batch_num].resize(n_targets_or_classes_, {0, 0});
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, n_trees_);
               for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(roots_[j], x_data));
+                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(j, x_data));
               }
             });
         for (size_t i = 1, limit = scores.size(); i < limit; ++i) {
@@ -461,17 +795,28 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         agg.FinalizeScores(scores[0], z_data, -1, label_data);
       }
     } else if (N <= parallel_N_) { /* section C2: 2+ outputs, 2+ rows, not enough rows to parallelize */
-      InlinedVector<ScoreValue<ThresholdType>> scores(n_targets_or_classes_);
-      size_t j, limit;
+      std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(
+          kTreeEnsembleRowBlockSize, InlinedVector<ScoreValue<ThresholdType>>(n_targets_or_classes_));
+      const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
 
-      for (int64_t i = 0; i < N; ++i) {
-        std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-        for (j = 0, limit = roots_.size(); j < limit; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+      for (int64_t i = 0; i < N; i += kTreeEnsembleRowBlockSize) {
+        const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, N - i);
+        for (int64_t r = 0; r < n_rows; ++r) {
+          // FinalizeScores may resize the scores of a row.
+          scores[r].resize(n_targets_or_classes_);
+          std::fill(scores[r].begin(), scores[r].end(), ScoreValue<ThresholdType>({0, 0}));
+        }
+        for (size_t j = 0, limit = roots_.size(); j < limit; ++j) {
+          ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+          for (int64_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction(scores[r], *leaves[r]);
+          }
         }
 
-        agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
-                           label_data == nullptr ? nullptr : (label_data + i));
+        for (int64_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores(scores[r], z_data + (i + r) * n_targets_or_classes_, -1,
+                             label_data == nullptr ? nullptr : (label_data + i + r));
+        }
       }
     } else if (n_trees_ >= max_num_threads) { /* section: D2: 2+ outputs, 2+ rows, enough trees to parallelize*/
       auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
@@ -481,13 +826,17 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           num_threads,
           [this, &agg, &scores, num_threads, x_data, N, stride](ptrdiff_t batch_num) {
             auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, this->n_trees_);
+            const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
             for (int64_t i = 0; i < N; ++i) {
               scores[batch_num * N + i].resize(n_targets_or_classes_, {0, 0});
             }
             for (auto j = work.start; j < work.end; ++j) {
-              for (int64_t i = 0; i < N; ++i) {
-                agg.ProcessTreeNodePrediction(scores[batch_num * N + i],
-                                              *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+              for (int64_t i = 0; i < N; i += kTreeEnsembleRowBlockSize) {
+                const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, N - i);
+                ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+                for (int64_t r = 0; r < n_rows; ++r) {
+                  agg.ProcessTreeNodePrediction(scores[batch_num * N + i + r], *leaves[r]);
+                }
               }
             }
           });
@@ -511,25 +860,85 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           ttp,
           num_threads,
           [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-            size_t j, limit;
-            InlinedVector<ScoreValue<ThresholdType>> scores(n_targets_or_classes_);
+            std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(
+                kTreeEnsembleRowBlockSize, InlinedVector<ScoreValue<ThresholdType>>(n_targets_or_classes_));
+            const TreeNodeElement<ThresholdType>* leaves[kTreeEnsembleRowBlockSize];
             auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
 
-            for (auto i = work.start; i < work.end; ++i) {
-              std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-              for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+            for (auto i = work.start; i < work.end; i += kTreeEnsembleRowBlockSize) {
+              const int64_t n_rows = std::min(kTreeEnsembleRowBlockSize, static_cast<int64_t>(work.end - i));
+              for (int64_t r = 0; r < n_rows; ++r) {
+                scores[r].resize(n_targets_or_classes_);
+                std::fill(scores[r].begin(), scores[r].end(), ScoreValue<ThresholdType>({0, 0}));
+              }
+              for (size_t j = 0, limit = roots_.size(); j < limit; ++j) {
+                ProcessTreeNodeLeaves(j, x_data + i * stride, stride, n_rows, leaves);
+                for (int64_t r = 0; r < n_rows; ++r) {
+                  agg.ProcessTreeNodePrediction(scores[r], *leaves[r]);
+                }
               }
 
-              agg.FinalizeScores(scores,
-                                 z_data + i * n_targets_or_classes_, -1,
-                                 label_data == nullptr ? nullptr : (label_data + i));
+              for (int64_t r = 0; r < n_rows; ++r) {
+                agg.FinalizeScores(scores[r],
+                                   z_data + (i + r) * n_targets_or_classes_, -1,
+                                   label_data == nullptr ? nullptr : (label_data + i + r));
+              }
             }
           });
     }
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggQuickScorer(concurrency::ThreadPool* ttp,
+                                                                                     const Tensor* X, Tensor* Z,
+                                                                                     Tensor* label,
+                                                                                     const AGG& agg) const {
+  int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
+  int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
+  OutputType* z_data = Z->template MutableData<OutputType>();
+
+  const InputType* x_data = X->template Data<InputType>();
+  int64_t* label_data = label == nullptr ? nullptr : label->template MutableData<int64_t>();
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+
+  // Every row goes through all the trees at once, so the work is only parallelized by rows.
+  auto num_threads = N <= parallel_N_ ? 1 : std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+        std::vector<uint64_t> leaf_bits(static_cast<size_t>(n_trees_));
+        InlinedVector<ScoreValue<ThresholdType>> scores;
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, N);
+
+        for (auto i = work.start; i < work.end; ++i) {
+          ProcessQuickScorer(x_data + i * stride, leaf_bits.data());
+
+          if (n_targets_or_classes_ == 1) {
+            ScoreValue<ThresholdType> score = {0, 0};
+            for (size_t j = 0; j < leaf_bits.size(); ++j) {
+              agg.ProcessTreeNodePrediction1(
+                  score, *qs_leaves_[qs_leaf_offsets_[j] + QuickScorerLowestBit(leaf_bits[j])]);
+            }
+
+            agg.FinalizeScores1(z_data + i, score, label_data == nullptr ? nullptr : (label_data + i));
+          } else {
+            scores.resize(n_targets_or_classes_);
+            std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
+            for (size_t j = 0; j < leaf_bits.size(); ++j) {
+              agg.ProcessTreeNodePrediction(
+                  scores, *qs_leaves_[qs_leaf_offsets_[j] + QuickScorerLowestBit(leaf_bits[j])]);
+            }
+
+            agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
+                               label_data == nullptr ? nullptr : (label_data + i));
+          }
+        }
+      });
+}
+
 #define TREE_FIND_VALUE(CMP)                                         \
   if (has_missing_tracks_) {                                         \
     while (root->is_not_leaf) {                                      \
@@ -636,6 +1045,119 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+#define FLAT_TREE_FIND_VALUE(CMP)                                                  \
+  if (has_missing_tracks_) {                                                       \
+    while (!(index & kFlatTreeLeafBit)) {                                          \
+      const FlatTreeNodeElement<ThresholdType>& node = nodes[index];               \
+      val = x_data[node.feature_id & ~kFlatTreeMissingTrackTrueBit];               \
+      index = (val CMP node.value ||                                               \
+               ((node.feature_id & kFlatTreeMissingTrackTrueBit) && _isnan_(val))) \
+                  ? node.truenode                                                  \
+                  : node.falsenode;                                                \
+    }                                                                              \
+  } else {                                                                         \
+    while (!(index & kFlatTreeLeafBit)) {                                          \
+      const FlatTreeNodeElement<ThresholdType>& node = nodes[index];               \
+      val = x_data[node.feature_id];                                               \
+      index = val CMP node.value ? node.truenode : node.falsenode;                 \
+    }                                                                              \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+const TreeNodeElement<ThresholdType>*
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessFlatTreeNodeLeave(
+    uint32_t index, const InputType* x_data) const {
+  const FlatTreeNodeElement<ThresholdType>* nodes = flat_nodes_.data();
+  InputType val;
+  switch (flat_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      FLAT_TREE_FIND_VALUE(<=)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      FLAT_TREE_FIND_VALUE(<)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      FLAT_TREE_FIND_VALUE(>=)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      FLAT_TREE_FIND_VALUE(>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      FLAT_TREE_FIND_VALUE(==)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      FLAT_TREE_FIND_VALUE(!=)
+      break;
+    case NODE_MODE::LEAF:
+      break;
+  }
+  return flat_leaves_[index & ~kFlatTreeLeafBit];
+}
+
+// Walks all the rows of the block one node at a time in turn, so their (independent) node loads are in flight
+// together instead of one row waiting on each load of its own path.
+#define FLAT_TREE_FIND_VALUES(CMP)                                                      \
+  for (bool active = true; active;) {                                                   \
+    active = false;                                                                     \
+    for (int64_t r = 0; r < n_rows; ++r) {                                              \
+      const uint32_t index = indices[r];                                                \
+      if (index & kFlatTreeLeafBit)                                                     \
+        continue;                                                                       \
+      const FlatTreeNodeElement<ThresholdType>& node = nodes[index];                    \
+      val = x_data[r * stride + (node.feature_id & ~kFlatTreeMissingTrackTrueBit)];     \
+      indices[r] = (val CMP node.value ||                                               \
+                    (has_missing_tracks_ &&                                             \
+                     (node.feature_id & kFlatTreeMissingTrackTrueBit) && _isnan_(val))) \
+                       ? node.truenode                                                  \
+                       : node.falsenode;                                                \
+      active = true;                                                                    \
+    }                                                                                   \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeaves(
+    size_t tree_index, const InputType* x_data, int64_t stride, int64_t n_rows,
+    const TreeNodeElement<ThresholdType>** leaves) const {
+  if (!use_flat_layout_) {
+    for (int64_t r = 0; r < n_rows; ++r) {
+      leaves[r] = ProcessTreeNodeLeave(roots_[tree_index], x_data + r * stride);
+    }
+    return;
+  }
+
+  const FlatTreeNodeElement<ThresholdType>* nodes = flat_nodes_.data();
+  uint32_t indices[kTreeEnsembleRowBlockSize];
+  std::fill_n(indices, n_rows, flat_roots_[tree_index]);
+
+  InputType val;
+  switch (flat_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      FLAT_TREE_FIND_VALUES(<=)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      FLAT_TREE_FIND_VALUES(<)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      FLAT_TREE_FIND_VALUES(>=)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      FLAT_TREE_FIND_VALUES(>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      FLAT_TREE_FIND_VALUES(==)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      FLAT_TREE_FIND_VALUES(!=)
+      break;
+    case NODE_MODE::LEAF:
+      break;
+  }
+
+  for (int64_t r = 0; r < n_rows; ++r) {
+    leaves[r] = flat_leaves_[indices[r] & ~kFlatTreeLeafBit];
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
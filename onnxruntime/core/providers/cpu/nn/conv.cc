@@ -18,6 +18,7 @@
 #include "core/providers/cpu/nn/conv.h"
 
 #include "core/common/safeint.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -152,7 +153,186 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+bool Conv<float>::IsFullyConnected(const TensorShape& weight_shape) const {
+  if (conv_attrs_.group != 1 ||
+      (conv_attrs_.auto_pad != AutoPadType::NOTSET && conv_attrs_.auto_pad != AutoPadType::VALID)) {
+    return false;
+  }
+
+  TensorShapeVector kernel_shape;
+  if (weight_shape.NumDimensions() < 3 || !conv_attrs_.ComputeKernelShape(weight_shape, kernel_shape).IsOK()) {
+    return false;
+  }
+
+  for (auto pad : conv_attrs_.pads) {
+    if (pad != 0) {
+      return false;
+    }
+  }
+
+  const auto* x_shape = Node().InputDefs()[0]->Shape();
+  if (x_shape == nullptr || x_shape->dim_size() != static_cast<int>(weight_shape.NumDimensions())) {
+    return false;
+  }
+
+  // each output is the dot product of a filter with a whole input image if the kernel matches the image size.
+  // the strides don't matter as there is a single output position.
+  for (size_t i = 0; i < kernel_shape.size(); ++i) {
+    const auto& dim = x_shape->dim(static_cast<int>(i) + 2);
+    if (!utils::HasDimValue(dim) || dim.dim_value() != kernel_shape[i]) {
+      return false;
+    }
+
+    if (kernel_shape[i] != 1 && !conv_attrs_.dilations.empty() && conv_attrs_.dilations[i] != 1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // MlasConv uses the filter in its original layout as the A matrix of its GEMMs, so there is nothing to pack
+  // unless the convolution is a fully connected layer and the filter can be the packed B matrix.
+  if (input_idx != 1 || !IsFullyConnected(tensor.Shape())) {
+    return Status::OK();
+  }
+
+  const size_t M = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t K = static_cast<size_t>(tensor.Shape().SizeFromDimension(1));
+
+  const size_t packed_w_size = MlasGemmPackBSize(M, K);
+  if (packed_w_size == 0) {
+    return Status::OK();
+  }
+
+  auto* packed_w_data = alloc->Alloc(packed_w_size);
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_w_data, 0, packed_w_size);
+
+  packed_w_ = BufferUniquePtr(packed_w_data, BufferDeleter(alloc));
+  MlasGemmPackB(CblasTrans, M, K, tensor.Data<float>(), K, packed_w_data);
+  w_shape_ = tensor.Shape();
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_w_));
+    prepacked_weights->buffer_sizes_.push_back(packed_w_size);
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_w_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<float>::UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                 /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  // the cache key doesn't include the shape of X, so check the buffers still apply
+  if (input_idx == 1 && IsFullyConnected(tensor.Shape())) {
+    used_persisted_buffers = true;
+    w_shape_ = tensor.Shape();
+    packed_w_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<float>::ComputeFullyConnected(OpKernelContext* context) const {
+  size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
+  const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), w_shape_));
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(w_shape_, kernel_shape));
+  for (size_t i = 0; i < kernel_shape.size(); ++i) {
+    ORT_RETURN_IF_NOT(X->Shape()[i + 2] == kernel_shape[i], "Input shape ", X->Shape(),
+                      " doesn't match the static shape the filter was packed for.");
+  }
+
+  const int64_t N = X->Shape()[0];
+  const int64_t M = w_shape_[0];
+  const int64_t K = w_shape_.SizeFromDimension(1);
+
+  TensorShapeVector Y_dims(w_shape_.NumDimensions(), 1);
+  Y_dims[0] = N;
+  Y_dims[1] = M;
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  auto* Ydata = Y->MutableData<float>();
+  float Beta = 0.0f;
+  if (Sum != nullptr) {
+    const auto& sum_shape = Sum->Shape();
+    ORT_RETURN_IF_NOT(Y->Shape() == sum_shape, "output and sum shape must match");
+    // If the output was not allocated inplace with the sum tensor, then copy here.
+    const auto* sum_data = Sum->Data<float>();
+    if (Ydata != sum_data) {
+      memcpy(Ydata, sum_data, sum_shape.Size() * sizeof(float));
+    }
+    Beta = 1.0f;
+  }
+
+  // Y is N x M here, so the bias is per column. Add it before the GEMM instead of with the activation.
+  if (B != nullptr) {
+    auto Ymatrix = EigenMatrixMap<float>(Ydata, M, N);
+    auto Bvec = ConstEigenVectorMap<float>(B->Data<float>(), M);
+    if (Beta == 0.0f) {
+      Ymatrix.colwise() = Bvec;
+    } else {
+      Ymatrix.colwise() += Bvec;
+    }
+    Beta = 1.0f;
+  }
+
+  MlasGemm(CblasNoTrans,
+           static_cast<size_t>(N),
+           static_cast<size_t>(M),
+           static_cast<size_t>(K),
+           1.0f,
+           X->Data<float>(),
+           static_cast<size_t>(K),
+           packed_w_.get(),
+           Beta,
+           Ydata,
+           static_cast<size_t>(M),
+           context->GetOperatorThreadPool());
+
+  MlasActivation(&activation_, Ydata, nullptr, 1, static_cast<size_t>(N * M), static_cast<size_t>(N * M));
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
+  if (packed_w_) {
+    return ComputeFullyConnected(context);
+  }
+
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
   const Tensor* W = context->Input<Tensor>(1);
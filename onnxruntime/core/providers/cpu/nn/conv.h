@@ -29,11 +29,33 @@ class Conv<float> : public OpKernel {
   }
 
   Status Compute(OpKernelContext* context) const override;
-  
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                      std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      /*out*/ bool& used_persisted_buffers) override;
+
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // Returns true if the static shape of X shows that each filter covers the whole input image, so the convolution
+  // is a fully connected layer (e.g. 1x1 convolutions after global pooling or convolutional classifier heads).
+  bool IsFullyConnected(const TensorShape& weight_shape) const;
+
+  Status ComputeFullyConnected(OpKernelContext* context) const;
+
+  // The filter packed as the B matrix of Y = X * W^T. Only set if IsFullyConnected().
+  TensorShape w_shape_;
+  BufferUniquePtr packed_w_;
 };
 
 }  // namespace onnxruntime
@@ -4,20 +4,16 @@
 #include "string_normalizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
-#include <codecvt>
 #include <locale.h>
-#elif defined(__APPLE__) or defined(__ANDROID__)
-#include <codecvt>
-#else
-#include <limits>
-#include <iconv.h>
 #endif  // _MSC_VER
 
+#include <atomic>
+#include <cwctype>
+#include <limits>
 #include <locale>
-#include <functional>
-#include <unordered_set>
 
 namespace onnxruntime {
 
@@ -29,8 +25,80 @@ ONNX_CPU_OPERATOR_KERNEL(
     StringNormalizer);
 
 namespace string_normalizer {
-const std::string conv_error("Conversion Error");
-const std::wstring wconv_error(L"Conversion Error");
+
+constexpr char32_t kMaxCodePoint = 0x10FFFF;
+
+inline bool IsSurrogate(char32_t cp) {
+  return cp >= 0xD800 && cp <= 0xDFFF;
+}
+
+// Code points below this are at most two bytes long in UTF-8 and cover the Latin, Greek, Cyrillic, Armenian,
+// Hebrew and Arabic scripts. Their case mappings are looked up in a table.
+constexpr char32_t kCaseTableSize = 0x800;
+
+// Decodes the code point that starts at s[pos] and moves pos past it.
+// Returns false for malformed, overlong or truncated sequences, surrogates and values above U+10FFFF.
+inline bool DecodeUtf8(std::string_view s, size_t& pos, char32_t& cp) {
+  const auto lead = static_cast<unsigned char>(s[pos]);
+  size_t length;
+  char32_t min_cp;
+  if (lead < 0x80) {
+    cp = lead;
+    ++pos;
+    return true;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    cp = lead & 0x1F;
+    min_cp = 0x80;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    cp = lead & 0x0F;
+    min_cp = 0x800;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    cp = lead & 0x07;
+    min_cp = 0x10000;
+  } else {
+    return false;
+  }
+
+  if (s.size() - pos < length) {
+    return false;
+  }
+
+  for (size_t i = 1; i < length; ++i) {
+    const auto c = static_cast<unsigned char>(s[pos + i]);
+    if ((c & 0xC0) != 0x80) {
+      return false;
+    }
+    cp = (cp << 6) | (c & 0x3F);
+  }
+
+  if (cp < min_cp || cp > kMaxCodePoint || IsSurrogate(cp)) {
+    return false;
+  }
+
+  pos += length;
+  return true;
+}
+
+inline void AppendUtf8(char32_t cp, std::string& out) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
 
 // We need to specialize for MS as there is
 // a std::locale creation bug that affects different
@@ -56,24 +124,15 @@ class Locale {
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
 
-  void ChangeCase(StringNormalizer::CaseAction caseaction,
-                  std::wstring& wstr) const {
+  wchar_t ChangeCase(StringNormalizer::CaseAction caseaction, wchar_t ch) const {
     assert(caseaction != StringNormalizer::NONE);
-    if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return ::_towlower_l(ch, loc_); });
-    } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return ::_towupper_l(ch, loc_); });
-    }
+    return caseaction == StringNormalizer::LOWER ? ::_towlower_l(ch, loc_) : ::_towupper_l(ch, loc_);
   }
 
  private:
   _locale_t loc_;
 };
 
-using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
-
 const std::string default_locale("en-US");
 
 #else  // MS_VER
@@ -94,154 +153,29 @@ class Locale {
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Locale);
 
-  void ChangeCase(StringNormalizer::CaseAction caseaction,
-                  std::wstring& wstr) const {
+  wchar_t ChangeCase(StringNormalizer::CaseAction caseaction, wchar_t ch) const {
     assert(caseaction != StringNormalizer::NONE);
-    if (caseaction == StringNormalizer::LOWER) {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::tolower(ch, loc_); });
-    } else {
-      std::transform(wstr.begin(), wstr.end(), wstr.begin(),
-                     [this](wchar_t ch) { return std::toupper(ch, loc_); });
-    }
+    return caseaction == StringNormalizer::LOWER ? std::tolower(ch, loc_) : std::toupper(ch, loc_);
   }
 
  private:
   std::locale loc_;
 };
 
-#if defined(__APPLE__) or defined(__ANDROID__)
-using Utf8Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
-#else
-
-// All others (Linux)
-class Utf8Converter {
- public:
-  Utf8Converter(const std::string&, const std::wstring&) {}
-
-  std::wstring from_bytes(const std::string& s) const {
-    std::wstring result;
-    if (s.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("WCHAR_T", "UTF-8");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return wconv_error;
-    }
-
-    char* iconv_in = const_cast<char*>(s.c_str());
-    size_t iconv_in_bytes = s.length();
-    // Temporary buffer assumes 1 byte to 1 wchar_t
-    // to make sure it is enough.
-    const size_t buffer_len = iconv_in_bytes * sizeof(wchar_t);
-    auto buffer = std::make_unique<char[]>(buffer_len);
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = wconv_error;
-    } else {
-      size_t converted_bytes = buffer_len - iconv_out_bytes;
-      assert((converted_bytes % sizeof(wchar_t)) == 0);
-      result.assign(reinterpret_cast<const wchar_t*>(buffer.get()), converted_bytes / sizeof(wchar_t));
-    }
-    iconv_close(icvt);
-    return result;
-  }
-
-  std::string to_bytes(const std::wstring& wstr) const {
-    std::string result;
-    if (wstr.empty()) {
-      return result;
-    }
-    // Order of arguments is to, from
-    auto icvt = iconv_open("UTF-8", "WCHAR_T");
-    // CentOS is not happy with -1
-    if (std::numeric_limits<iconv_t>::max() == icvt) {
-      return conv_error;
-    }
-
-    // I hope this does not modify the incoming buffer
-    wchar_t* non_const_in = const_cast<wchar_t*>(wstr.c_str());
-    char* iconv_in = reinterpret_cast<char*>(non_const_in);
-    size_t iconv_in_bytes = wstr.length() * sizeof(wchar_t);
-    // Temp buffer, assume every code point converts into 3 bytes, this should be enough
-    // We do not convert terminating zeros
-    const size_t buffer_len = wstr.length() * 3;
-    auto buffer = std::make_unique<char[]>(buffer_len);
-
-    char* iconv_out = buffer.get();
-    size_t iconv_out_bytes = buffer_len;
-    auto ret = iconv(icvt, &iconv_in, &iconv_in_bytes, &iconv_out, &iconv_out_bytes);
-    if (static_cast<size_t>(-1) == ret) {
-      result = conv_error;
-    } else {
-      size_t converted_len = buffer_len - iconv_out_bytes;
-      result.assign(buffer.get(), converted_len);
-    }
-    iconv_close(icvt);
-    return result;
-  }
-};
-
-#endif  // __APPLE__
-
 const std::string default_locale("en_US.UTF-8");  // All non-MS
 
 #endif  // MS_VER
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      Utf8Converter& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
-  std::vector<int64_t> output_dims;
-  if (N == 1) {
-    output_dims.push_back(1);
-  }
-
-  // Empty output case
-  if (C == 0) {
-    output_dims.push_back(1);
-    TensorShape output_shape(output_dims);
-    // This will create one empty string
-    ctx->Output(0, output_shape);
-    return Status::OK();
-  }
-
-  output_dims.push_back(C);
-
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
-
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        // Please do not include the input text in the error message as it could
-        // be deemed as a compliance violation by teams using this operator
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars");
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
-    }
-    ++output_idx;
-    ++first;
+// Maps a code point with the locale. Code points that do not fit in a wchar_t (Windows) and mappings that are
+// not valid code points are left unchanged.
+inline char32_t ChangeCase(const Locale& locale, StringNormalizer::CaseAction caseaction, char32_t cp) {
+  if (cp > static_cast<char32_t>(std::numeric_limits<wchar_t>::max())) {
+    return cp;
   }
-  return Status::OK();
+  const auto mapped = static_cast<char32_t>(locale.ChangeCase(caseaction, static_cast<wchar_t>(cp)));
+  return (mapped > kMaxCodePoint || IsSurrogate(mapped)) ? cp : mapped;
 }
+
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
@@ -273,29 +207,72 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
+  locale_ = std::make_unique<Locale>(info.GetAttrOrDefault("locale", default_locale));
+
+  lower_table_.resize(kCaseTableSize);
+  upper_table_.resize(kCaseTableSize);
+  for (char32_t cp = 0; cp < kCaseTableSize; ++cp) {
+    lower_table_[cp] = string_normalizer::ChangeCase(*locale_, LOWER, cp);
+    upper_table_[cp] = string_normalizer::ChangeCase(*locale_, UPPER, cp);
+  }
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
+  size_t arena_size = 0;
   for (auto& sw : swords) {
     ORT_ENFORCE(!sw.empty(), "Empty stopwords not allowed");
-    if (is_case_sensitive_) {
-      auto p = stopwords_.insert(std::move(sw));
-      ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
-    } else {
-      std::wstring wstr = converter.from_bytes(sw);
-      ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
-      auto p = wstopwords_.insert(std::move(wstr));
-      ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
+    if (!is_case_sensitive_) {
+      std::string cased;
+      ORT_ENFORCE(ChangeCase(sw, compare_caseaction_, cased), "Stopword contains invalid utf8 chars");
+      sw = std::move(cased);
     }
+    arena_size += sw.size();
+  }
+
+  // the arena must not reallocate once views of it have been taken
+  stopwords_arena_.reserve(arena_size);
+  stopwords_.reserve(swords.size());
+  for (const auto& sw : swords) {
+    std::string_view view(stopwords_arena_.data() + stopwords_arena_.size(), sw.size());
+    stopwords_arena_.append(sw);
+    auto p = stopwords_.insert(view);
+    ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
   }
 }
 
-Status StringNormalizer::Compute(OpKernelContext* ctx) const {
-  using namespace string_normalizer;
+StringNormalizer::~StringNormalizer() = default;
+
+bool StringNormalizer::ChangeCase(std::string_view s, CaseAction caseaction, std::string& out) const {
+  assert(caseaction != NONE);
+  const auto& table = (caseaction == LOWER) ? lower_table_ : upper_table_;
+
+  // Most text is ASCII, which maps to ASCII in nearly all locales, so it is changed in place byte by byte.
+  // The rest of the string is decoded from the first byte where that does not hold.
+  out.assign(s.data(), s.size());
+  size_t pos = 0;
+  for (; pos < s.size(); ++pos) {
+    const auto c = static_cast<unsigned char>(s[pos]);
+    if (c >= 0x80 || table[c] >= 0x80) {
+      break;
+    }
+    out[pos] = static_cast<char>(table[c]);
+  }
 
+  if (pos == s.size()) {
+    return true;
+  }
+
+  out.resize(pos);
+  while (pos < s.size()) {
+    char32_t cp;
+    if (!DecodeUtf8(s, pos, cp)) {
+      return false;
+    }
+    AppendUtf8(cp < kCaseTableSize ? table[cp] : string_normalizer::ChangeCase(*locale_, caseaction, cp), out);
+  }
+  return true;
+}
+
+Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   auto X = ctx->Input<Tensor>(0);
   if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   auto input_dims = X->Shape().GetDims();
@@ -320,72 +297,96 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  Utf8Converter converter(conv_error, wconv_error);
   auto* const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
-  if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      InlinedVector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
-        }
-        ++first;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // The strings are independent, so both the filtering and the case change are split across the thread pool.
+  // The cost of a string is proportional to its length.
+  size_t total_length = 0;
+  for (size_t i = 0; i < C; ++i) {
+    total_length += input_data[i].size();
+  }
+  const double average_length = static_cast<double>(total_length) / static_cast<double>(C) + 1.0;
+  const TensorOpCost cost{average_length, average_length, average_length * 4.0};
+
+  // Please do not include the input text in the error message as it could
+  // be deemed as a compliance violation by teams using this operator
+  std::atomic<bool> invalid_utf8{false};
+  const auto invalid_utf8_status = [] {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Input contains invalid utf8 chars");
+  };
+
+  // Indices of the input strings that are not stopwords
+  std::vector<size_t> kept;
+  if (!stopwords_.empty()) {
+    std::vector<uint8_t> is_kept(C);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(C), cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::string cased;  // reused by the strings of this range
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            std::string_view s = input_data[i];
+            if (!is_case_sensitive_) {
+              if (!ChangeCase(s, compare_caseaction_, cased)) {
+                invalid_utf8 = true;
+                return;
+              }
+              s = cased;
+            }
+            is_kept[i] = stopwords_.find(s) == stopwords_.end();
+          }
+        });
+
+    if (invalid_utf8) {
+      return invalid_utf8_status();
+    }
+
+    kept.reserve(C);
+    for (size_t i = 0; i < C; ++i) {
+      if (is_kept[i]) {
+        kept.push_back(i);
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
     }
-  } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      InlinedVector<StrRef> filtered_orignal_strings;
-      InlinedVector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        std::wstring wstr = converter.from_bytes(s);
-        if (wstr == wconv_error) {
-          // Please do not include the input text in the error message as it could
-          // be deemed as a compliance violation by teams using this operator
-          return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                        "Input contains invalid utf8 chars");
-        }
-        locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
+  }
+
+  const size_t output_count = stopwords_.empty() ? C : kept.size();
+
+  std::vector<int64_t> output_dims;
+  if (N == 1) {
+    output_dims.push_back(1);
+  }
+
+  // Empty output case
+  if (output_count == 0) {
+    output_dims.push_back(1);
+    TensorShape output_shape(output_dims);
+    // This will create one empty string
+    ctx->Output(0, output_shape);
+    return Status::OK();
+  }
+
+  output_dims.push_back(output_count);
+  TensorShape output_shape(output_dims);
+  auto* const output_data = ctx->Output(0, output_shape)->template MutableData<std::string>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(output_count), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const std::string& s = input_data[kept.empty() ? i : kept[i]];
           if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
-          } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
+            output_data[i] = s;
+          } else if (!ChangeCase(s, case_change_action_, output_data[i])) {
+            invalid_utf8 = true;
+            return;
           }
         }
-        ++first;
-      }
-      if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
-      } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
-      }
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
-    }
+      });
+
+  if (invalid_utf8) {
+    return invalid_utf8_status();
   }
-  return status;
+
+  return Status::OK();
 }
 }  // namespace onnxruntime
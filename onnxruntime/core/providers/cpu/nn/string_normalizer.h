@@ -6,11 +6,17 @@
 #include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
 
-#include <locale>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace onnxruntime {
 
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -20,18 +26,26 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
  private:
+  // Writes s with the case of its characters changed to out, working on the UTF-8 bytes directly.
+  // Returns false if s is not valid UTF-8.
+  bool ChangeCase(std::string_view s, CaseAction caseaction, std::string& out) const;
+
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
-  InlinedHashSet<std::string> stopwords_;
-  InlinedHashSet<std::wstring> wstopwords_;
+  std::unique_ptr<string_normalizer::Locale> locale_;
+  // Case mappings of the code points that are one or two bytes long in UTF-8, built from the locale.
+  // The other code points go through the locale one at a time.
+  std::vector<char32_t> lower_table_;
+  std::vector<char32_t> upper_table_;
+  // The stopwords, with compare_caseaction_ applied if not case sensitive, are views of stopwords_arena_
+  std::string stopwords_arena_;
+  InlinedHashSet<std::string_view> stopwords_;
 };
 
 }  // namespace onnxruntime
@@ -13,7 +13,9 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include "core/platform/threadpool.h"
+#include <algorithm>
+#include <cmath>
 #include <utility>
 //TODO:fix the warnings
 #ifdef _MSC_VER
@@ -114,6 +116,145 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+};
+
+// Candidates are visited by descending score, then by ascending box index. NaN scores are visited last so that the
+// order is a strict weak ordering.
+inline bool VisitBefore(const BoxInfoPtr& lhs, const BoxInfoPtr& rhs) {
+  if (lhs.score_ > rhs.score_) {
+    return true;
+  }
+  if (lhs.score_ < rhs.score_) {
+    return false;
+  }
+  const bool lhs_is_nan = std::isnan(lhs.score_);
+  const bool rhs_is_nan = std::isnan(rhs.score_);
+  if (lhs_is_nan != rhs_is_nan) {
+    return rhs_is_nan;
+  }
+  return lhs.index_ < rhs.index_;
+}
+
+// Corners and areas of boxes in structure of arrays layout, computed as SuppressByIOU computes them.
+struct BoxCorners {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Reserve(size_t count) {
+    x_min.reserve(count);
+    y_min.reserve(count);
+    x_max.reserve(count);
+    y_max.reserve(count);
+    area.reserve(count);
+  }
+
+  void Clear() {
+    x_min.clear();
+    y_min.clear();
+    x_max.clear();
+    y_max.clear();
+    area.clear();
+  }
+
+  void Add(const float* box, int64_t center_point_box) {
+    float box_x_min{};
+    float box_y_min{};
+    float box_x_max{};
+    float box_y_max{};
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], box_x_min, box_x_max);
+      MaxMin(box[0], box[2], box_y_min, box_y_max);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      box_x_min = box[0] - width_half;
+      box_x_max = box[0] + width_half;
+      box_y_min = box[1] - height_half;
+      box_y_max = box[1] + height_half;
+    }
+    x_min.push_back(box_x_min);
+    y_min.push_back(box_y_min);
+    x_max.push_back(box_x_max);
+    y_max.push_back(box_y_max);
+    area.push_back((box_x_max - box_x_min) * (box_y_max - box_y_min));
+  }
+
+  void Add(const BoxCorners& other, size_t index) {
+    x_min.push_back(other.x_min[index]);
+    y_min.push_back(other.y_min[index]);
+    x_max.push_back(other.x_max[index]);
+    y_max.push_back(other.y_max[index]);
+    area.push_back(other.area[index]);
+  }
+
+  size_t Size() const {
+    return area.size();
+  }
+};
+
+// Returns true if box `index` of `boxes` has an IOU over iou_threshold with any of the selected boxes. This gives the
+// same result as SuppressByIOU for each pair. The loop over a block of selected boxes has no branch so that it is
+// vectorized.
+bool SuppressBySelectedIOU(const BoxCorners& boxes, size_t index, const BoxCorners& selected, float iou_threshold) {
+  constexpr size_t block_size = 16;
+
+  const float x1_min = boxes.x_min[index];
+  const float y1_min = boxes.y_min[index];
+  const float x1_max = boxes.x_max[index];
+  const float y1_max = boxes.y_max[index];
+  const float area1 = boxes.area[index];
+  if (!(area1 > .0f)) {
+    return false;
+  }
+
+  const float* x2_min = selected.x_min.data();
+  const float* y2_min = selected.y_min.data();
+  const float* x2_max = selected.x_max.data();
+  const float* y2_max = selected.y_max.data();
+  const float* area2 = selected.area.data();
+  const size_t count = selected.Size();
+
+  for (size_t begin = 0; begin < count; begin += block_size) {
+    const size_t end = std::min(begin + block_size, count);
+    int suppressed = 0;
+    for (size_t i = begin; i < end; ++i) {
+      const float intersection_x_min = std::max(x1_min, x2_min[i]);
+      const float intersection_x_max = std::min(x1_max, x2_max[i]);
+      const float intersection_y_min = std::max(y1_min, y2_min[i]);
+      const float intersection_y_max = std::min(y1_max, y2_max[i]);
+      const float intersection_area = (intersection_x_max - intersection_x_min) *
+                                      (intersection_y_max - intersection_y_min);
+      const float union_area = area1 + area2[i] - intersection_area;
+      suppressed |= static_cast<int>(intersection_x_max > intersection_x_min) &
+                    static_cast<int>(intersection_y_max > intersection_y_min) &
+                    static_cast<int>(intersection_area > .0f) &
+                    static_cast<int>(area2[i] > .0f) &
+                    static_cast<int>(union_area > .0f) &
+                    static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -131,71 +272,101 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
+  const size_t num_boxes = static_cast<size_t>(pc.num_boxes_);
+  const size_t max_selected = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), num_boxes);
+  auto* tp = ctx->GetOperatorThreadPool();
+
+  // The corners of the boxes of a batch are shared by all the classes.
+  std::vector<BoxCorners> batch_corners(static_cast<size_t>(pc.num_batches_));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(pc.num_batches_), static_cast<double>(num_boxes) * 8,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t batch_index = begin; batch_index != end; ++batch_index) {
+          BoxCorners& corners = batch_corners[static_cast<size_t>(batch_index)];
+          corners.Reserve(num_boxes);
+          const float* batch_boxes = boxes_data + batch_index * num_boxes * 4;
+          for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+            corners.Add(batch_boxes + box_index * 4, center_point_box);
           }
         }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+      });
+
+  // Each batch and class is processed independently. The selected box indices of each are concatenated in order.
+  const std::ptrdiff_t num_tasks = static_cast<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<int64_t>> selected_per_task(static_cast<size_t>(num_tasks));
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_tasks, static_cast<double>(num_boxes) * 32,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        std::vector<BoxInfoPtr> candidate_boxes;
+        candidate_boxes.reserve(num_boxes);
+        BoxCorners selected_corners;
+        selected_corners.Reserve(max_selected);
+
+        for (std::ptrdiff_t task = begin; task != end; ++task) {
+          const int64_t batch_index = task / pc.num_classes_;
+          const BoxCorners& corners = batch_corners[static_cast<size_t>(batch_index)];
+          std::vector<int64_t>& selected_boxes_inside_class = selected_per_task[static_cast<size_t>(task)];
+
+          // Filter by score_threshold_
+          const auto* class_scores = scores_data + task * pc.num_boxes_;
+          candidate_boxes.clear();
+          if (pc.score_threshold_ != nullptr) {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              if (*class_scores > score_threshold) {
+                candidate_boxes.emplace_back(*class_scores, box_index);
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
+              candidate_boxes.emplace_back(*class_scores, box_index);
+            }
           }
-        }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          selected_corners.Clear();
+
+          // Only the top candidates are usually visited before max_output_boxes_per_class boxes are selected, so the
+          // candidates are ordered a chunk at a time with a partial selection instead of sorting all of them.
+          auto chunk_begin = candidate_boxes.begin();
+          size_t chunk_size = std::max<size_t>(2 * max_selected, 64);
+          while (chunk_begin != candidate_boxes.end() && selected_boxes_inside_class.size() < max_selected) {
+            auto chunk_end = chunk_begin + std::min<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(chunk_size),
+                                                                    candidate_boxes.end() - chunk_begin);
+            if (chunk_end != candidate_boxes.end()) {
+              std::nth_element(chunk_begin, chunk_end, candidate_boxes.end(), VisitBefore);
+            }
+            std::sort(chunk_begin, chunk_end, VisitBefore);
+
+            // Get the next box with top score, filter by iou_threshold
+            for (; chunk_begin != chunk_end && selected_boxes_inside_class.size() < max_selected; ++chunk_begin) {
+              const size_t box_index = static_cast<size_t>(chunk_begin->index_);
+              // Check with existing selected boxes for this class, suppress if exceed the IOU threshold
+              if (!SuppressBySelectedIOU(corners, box_index, selected_corners, iou_threshold)) {
+                selected_corners.Add(corners, box_index);
+                selected_boxes_inside_class.push_back(chunk_begin->index_);
+              }
+            }
+            chunk_begin = chunk_end;
+            chunk_size *= 2;
+          }
         }
-        sorted_boxes.pop();
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+      });
+
+  size_t num_selected = 0;
+  for (const auto& selected : selected_per_task) {
+    num_selected += selected.size();
+  }
+
+  std::vector<SelectedIndex> selected_indices;
+  selected_indices.reserve(num_selected);
+  for (std::ptrdiff_t task = 0; task < num_tasks; ++task) {
+    for (int64_t box_index : selected_per_task[static_cast<size_t>(task)]) {
+      selected_indices.emplace_back(task / pc.num_classes_, task % pc.num_classes_, box_index);
+    }
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
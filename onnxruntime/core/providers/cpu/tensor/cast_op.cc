@@ -15,6 +15,8 @@
 #include "core/framework/data_types.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
@@ -22,10 +24,6 @@
 #include "Eigen/src/Core/arch/Default/BFloat16.h"
 #include "Eigen/src/Core/arch/Default/Half.h"
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-#include "core/mlas/inc/mlas.h"
-#endif
-
 namespace onnxruntime {
 
 namespace op_kernel_type_control {
@@ -171,36 +169,52 @@ struct EigenCastType<BFloat16> {
   using type = Eigen::bfloat16;
 };
 
+// Run cast_range(begin, end) over the elements of the tensor, split across the operator thread pool when the
+// tensor is large enough for that to pay off.
+template <typename SrcType, typename DstType, typename CastRangeFn>
+void ParallelCast(const OpKernelContext& context, const TensorShape& shape, double compute_cycles,
+                  CastRangeFn&& cast_range) {
+  const std::ptrdiff_t shape_size = gsl::narrow<std::ptrdiff_t>(shape.Size());
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), shape_size,
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), compute_cycles},
+      cast_range);
+}
+
 // generic tensor X -> Y
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCaster {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     using SrcEigenCastType = typename EigenCastType<SrcType>::type;
     using DstEigenCastType = typename EigenCastType<DstType>::type;
 
-    const std::ptrdiff_t shape_size = gsl::narrow<std::ptrdiff_t>(shape.Size());
-    const auto in_vector =
-        ConstEigenVectorMap<SrcEigenCastType>(reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>()), shape_size);
-    auto out_vector =
-        EigenVectorMap<DstEigenCastType>(reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>()), shape_size);
-    out_vector = in_vector.template cast<DstEigenCastType>();
+    const auto* in_data = reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>());
+    auto* out_data = reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>());
+    ParallelCast<SrcType, DstType>(context, shape, 1.0, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      const auto in_vector = ConstEigenVectorMap<SrcEigenCastType>(in_data + begin, end - begin);
+      auto out_vector = EigenVectorMap<DstEigenCastType>(out_data + begin, end - begin);
+      out_vector = in_vector.template cast<DstEigenCastType>();
+    });
   }
 };
 
 // tensor X -> string
 template <typename SrcType>
 struct TensorCaster<SrcType, std::string> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    const std::ptrdiff_t shape_size = gsl::narrow<std::ptrdiff_t>(shape.Size());
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const auto* in_data = in.Data<SrcType>();
     auto* out_data = out.MutableData<std::string>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      CastToString(in_data[i], out_data[i]);
-    }
+    const auto cast_range = [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i < end; ++i) {
+        CastToString(in_data[i], out_data[i]);
+      }
+    };
+    ParallelCast<SrcType, std::string>(context, shape, 256.0, cast_range);
   }
 };
 
 // tensor string -> X
+// N.B. this stays on the calling thread because parsing invalid input throws.
 template <typename DstType>
 struct TensorCaster<std::string, DstType> {
   void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
@@ -213,18 +227,34 @@ struct TensorCaster<std::string, DstType> {
   }
 };
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-// specializations to use optimized and Windows x64-specific
-// MlasConvertHalfToFloatBuffer() routine for MLFloat16 -> float conversion
+// specializations to use the vectorized MLAS routines for float16 <-> float conversions
 
-// tensor MLFloat16 -> float
-template <>
-struct TensorCaster<MLFloat16, float> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    auto out_data = out.MutableData<float>();
-    auto in_data = in.Data<MLFloat16>();
-    const size_t shape_size = gsl::narrow<size_t>(shape.Size());
-    MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
+template <typename T>
+constexpr MLAS_HALF_TYPE MlasHalfTypeOf = std::is_same<T, BFloat16>::value ? MlasHalfTypeBf16 : MlasHalfTypeFp16;
+
+// tensor MLFloat16/BFloat16 -> float
+template <typename SrcType>
+struct TensorCaster<SrcType, float, typename std::enable_if<IsOrtFloat16Type<SrcType>::value>::type> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = in.Data<SrcType>();
+    auto* out_data = out.MutableData<float>();
+    ParallelCast<SrcType, float>(context, shape, 1.0, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertHalfToFloat(MlasHalfTypeOf<SrcType>, &in_data[begin].val, out_data + begin,
+                             static_cast<size_t>(end - begin));
+    });
+  }
+};
+
+// tensor float -> MLFloat16/BFloat16
+template <typename DstType>
+struct TensorCaster<float, DstType, typename std::enable_if<IsOrtFloat16Type<DstType>::value>::type> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = in.Data<float>();
+    auto* out_data = out.MutableData<DstType>();
+    ParallelCast<float, DstType>(context, shape, 1.0, [in_data, out_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      MlasConvertFloatToHalf(MlasHalfTypeOf<DstType>, in_data + begin, &out_data[begin].val,
+                             static_cast<size_t>(end - begin));
+    });
   }
 };
 
@@ -247,7 +277,9 @@ void CastMLFloat16ThroughFloatTensor(
 
 // tensor MLFloat16 -> X
 template <typename DstType>
-struct TensorCaster<MLFloat16, DstType> {
+struct TensorCaster<MLFloat16, DstType,
+                    typename std::enable_if<!std::is_same<DstType, float>::value &&
+                                            !std::is_same<DstType, std::string>::value>::type> {
   void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     CastMLFloat16ThroughFloatTensor<DstType>(context, shape, in, out);
   }
@@ -260,7 +292,6 @@ struct TensorCaster<MLFloat16, std::string> {
     CastMLFloat16ThroughFloatTensor<std::string>(context, shape, in, out);
   }
 };
-#endif
 
 class Cast final : public OpKernel {
  public:
@@ -323,131 +323,189 @@ static Status PadImpl(OpKernelContext* ctx,
     return PadInputWithDimValueOfZero(ctx, mode, orig_input_shape, output_dims, value);
   }
 
+  // Leading axes without padding or slicing are independent of each other, so they are collapsed into a single
+  // outer axis and ranges of it are padded in parallel. An outer axis of size 1 is added if there are none.
+  const int64_t inner_pre_pad = pads[inner_axis];
+  const int64_t inner_post_pad = pads[inner_axis + data_rank];
+
+  size_t outer_axes = 0;
+  int64_t outer_size = 1;
+  while (outer_axes < inner_axis &&
+         reshaped_pad[outer_axes] == 0 && reshaped_pad[outer_axes + new_dims_count] == 0 &&
+         reshaped_slice[outer_axes] == 0 && reshaped_slice[outer_axes + new_dims_count] == 0) {
+    outer_size *= reshaped_input_dims[outer_axes];
+    outer_axes++;
+  }
+
+  auto collapse_outer_axes = [outer_axes](TensorShapeVector& values, int64_t outer_value) {
+    if (outer_axes == 0) {
+      values.insert(values.begin(), outer_value);
+    } else {
+      values.erase(values.begin(), values.begin() + (outer_axes - 1));
+      values[0] = outer_value;
+    }
+  };
+
+  collapse_outer_axes(reshaped_input_dims, outer_size);
+  collapse_outer_axes(reshaped_output_dims, outer_size);
+  collapse_outer_axes(input_starts, 0);
+  collapse_outer_axes(input_extents, outer_size);
+
+  PadsVector outer_pad;
+  outer_pad.reserve(2 * reshaped_input_dims.size());
+  outer_pad.push_back(0);
+  outer_pad.insert(outer_pad.end(), reshaped_pad.begin() + outer_axes, reshaped_pad.begin() + new_dims_count);
+  outer_pad.push_back(0);
+  outer_pad.insert(outer_pad.end(), reshaped_pad.begin() + new_dims_count + outer_axes, reshaped_pad.end());
+  reshaped_pad = std::move(outer_pad);
+
+  new_dims_count = reshaped_input_dims.size();
+  inner_axis = new_dims_count - 1;
+
   TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<T> input(input_tensor, input_shape, input_starts, input_extents, {});
 
   // output_shape need to keep original.
   TensorShape output_shape(output_dims);
   auto& output_tensor = *ctx->Output(0, output_shape);
-  auto* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
+  auto* output_data = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
 
   TensorPitches output_pitches(reshaped_output_dims);
-  size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
+  size_t initial_align_skip = 0;  // Amount to skip to align to where the first input tensor data needs to be written
 
   // Initial skip, sum up the begin padding on each axis
   for (size_t i = 0; i < new_dims_count; i++)
-    alignSkip += reshaped_pad[i] * output_pitches[i];
-
-  ExtentAxisCounters input_counters(input_extents);
-
-  switch (mode) {
-    case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
-
-    case Mode::Edge:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          if (inner_no_pad_size == 1) {
-            PadAxisConstant(axisStart - prePad, *axisStart, prePad);
-            PadAxisConstant(output, *(output - 1), postPad);
-          } else {
-            // When inner_most axis(es) do not need pad, above PadAxisConstant() do not fit for Edge mode.
-            // Also general loop below after handling first pad axis with non-pad axis works fine.
-            PadAxis(axisStart - prePad, axisStart, 1, -ptrdiff_t(inner_no_pad_size), inner_no_pad_size, pads[inner_axis]);
-            PadAxis(output, output - inner_no_pad_size, 1, -ptrdiff_t(inner_no_pad_size), inner_no_pad_size, pads[inner_axis + data_rank]);
+    initial_align_skip += reshaped_pad[i] * output_pitches[i];
+
+  const int64_t input_block_size = TensorShape(input_extents).SizeFromDimension(1);
+  const int64_t output_block_size = output_pitches[0];
+
+  auto pad_outer_range = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    TensorShapeVector range_starts(input_starts);
+    TensorShapeVector range_extents(input_extents);
+    range_starts[0] = first;
+    range_extents[0] = last - first;
+
+    SliceIterator<T> input(input_tensor, input_shape, range_starts, range_extents, {});
+    ExtentAxisCounters input_counters(range_extents);
+
+    T* output = output_data + first * output_block_size;
+    size_t alignSkip = initial_align_skip;  // Amount to skip to align to where the next input tensor data needs to be written
+
+    switch (mode) {
+      case Mode::Constant:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            PadAxisConstant(axisStart - prePad, value, prePad);
+            PadAxisConstant(output, value, postPad);
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * range_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
+            PadAxisConstant(output, value, postPad * inner_pitch);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
           }
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
         }
-      }
-      break;
-
-    case Mode::Reflect:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          if (inner_no_pad_size == 1) {
-            PadInnermostAxis(axisStart - prePad, axisStart + prePad, -1 /* inputDelta */, prePad);
-            PadInnermostAxis(output, output - 2, -1 /* inputDelta */, postPad);
-          } else {
-            // When inner_most axis(es) do not need pad, Above PadInnermostAxis() do not fit for Reflect mode.
-            PadAxis(axisStart - prePad, axisStart + prePad, 1, -ptrdiff_t(inner_no_pad_size * 2), inner_no_pad_size, pads[inner_axis]);
-            PadAxis(output, output - 2 * inner_no_pad_size, 1, -ptrdiff_t(inner_no_pad_size * 2), inner_no_pad_size, pads[inner_axis + data_rank]);
+        break;
+
+      case Mode::Edge:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            if (inner_no_pad_size == 1) {
+              PadAxisConstant(axisStart - prePad, *axisStart, prePad);
+              PadAxisConstant(output, *(output - 1), postPad);
+            } else {
+              // When inner_most axis(es) do not need pad, above PadAxisConstant() do not fit for Edge mode.
+              // Also general loop below after handling first pad axis with non-pad axis works fine.
+              PadAxis(axisStart - prePad, axisStart, 1, -ptrdiff_t(inner_no_pad_size), inner_no_pad_size, inner_pre_pad);
+              PadAxis(output, output - inner_no_pad_size, 1, -ptrdiff_t(inner_no_pad_size), inner_no_pad_size, inner_post_pad);
+            }
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * range_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
+            PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
           }
-          output += postPad;
-          alignSkip = prePad;
         }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2,
-                  inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
+        break;
+
+      case Mode::Reflect:
+        // Loop over the output tensor, writing out padding between the blocks of copied data
+        // On loop entry, 'pad' is already set to the first continuous block of padding, and
+        // after every pass through the inner loop it gets set to the next continuous pad size.
+        while (input_counters) {
+          output += alignSkip;
+          {
+            T* axisStart = output;
+            output = input.CopyInnermostAxisSolitaryInnerStep(output);
+
+            int64_t prePad = reshaped_pad[inner_axis];
+            int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
+            if (inner_no_pad_size == 1) {
+              PadInnermostAxis(axisStart - prePad, axisStart + prePad, -1 /* inputDelta */, prePad);
+              PadInnermostAxis(output, output - 2, -1 /* inputDelta */, postPad);
+            } else {
+              // When inner_most axis(es) do not need pad, Above PadInnermostAxis() do not fit for Reflect mode.
+              PadAxis(axisStart - prePad, axisStart + prePad, 1, -ptrdiff_t(inner_no_pad_size * 2), inner_no_pad_size, inner_pre_pad);
+              PadAxis(output, output - 2 * inner_no_pad_size, 1, -ptrdiff_t(inner_no_pad_size * 2), inner_no_pad_size, inner_post_pad);
+            }
+            output += postPad;
+            alignSkip = prePad;
+          }
+          // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
+          while (input_counters.Increment()) {
+            ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
+            T* axisStart = output - inner_pitch * range_extents[input_counters.Axis()];
+            int64_t prePad = reshaped_pad[input_counters.Axis()];
+            int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
+            PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2,
+                    inner_pitch, prePad);
+            PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
+            output += inner_pitch * postPad;
+            alignSkip += inner_pitch * prePad;
+          }
         }
-      }
-      break;
-  }
+        break;
+    }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(outer_size),
+      TensorOpCost{static_cast<double>(input_block_size * sizeof(T)), static_cast<double>(output_block_size * sizeof(T)),
+                   static_cast<double>(output_block_size)},
+      pad_outer_range);
 
   return Status::OK();
 }
@@ -6,6 +6,7 @@
 #include <limits>
 #include <unordered_map>
 
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
@@ -222,41 +223,21 @@ static Status SliceImpl(OpKernelContext* ctx,
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  // use MutableDataRaw as actual data type in tensor may not match as we templatize on data size
-  T* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
-  const auto* output_end = output + output_tensor.Shape().Size();
-
-  auto create_output = [&output, &output_end](SliceIterator<T>& slice_input_iterator) {
-    if (slice_input_iterator.SolitaryInnerStep()) {
-      while (output < output_end) {
-        output = slice_input_iterator.CopyInnermostAxisSolitaryInnerStep(output);
-      }
-    } else {
-      while (output < output_end) {
-        output = slice_input_iterator.CopyInnermostAxisNonSolitaryInnerStep(output);
-      }
-    }
-
-    ORT_ENFORCE(output == output_end);
-  };
-
-  if (compute_metadata.p_flattened_output_dims_) {
-    // if we have flattened output dims we need to also flatten the input dims.
-    // as we're combining the innermost dims and keeping all values we can just copy the size of the last dim
-    auto flattened_input_dims = input_tensor.Shape().AsShapeVector();
-    flattened_input_dims.resize(compute_metadata.p_flattened_output_dims_->size());
-    flattened_input_dims.back() = compute_metadata.p_flattened_output_dims_->back();
-    TensorShape input_shape(flattened_input_dims);
-
-    auto input_iterator2 = SliceIterator<T>(input_tensor, input_shape, compute_metadata.starts_,
-                                            *compute_metadata.p_flattened_output_dims_, compute_metadata.steps_);
-    create_output(input_iterator2);
-  } else {
-    auto input_iterator2 = SliceIterator<T>(input_tensor, compute_metadata.starts_, compute_metadata.output_dims_,
-                                            compute_metadata.steps_);
-    create_output(input_iterator2);
+  // read the input from the first element of the slice with the input strides scaled by the steps.
+  // StridedCopy coalesces any inner dimensions that are copied in full and splits the copy across threads.
+  const auto input_strides = StridesForTensor(input_tensor);
+  TensorShapeVector src_strides(input_strides.size());
+  std::ptrdiff_t src_offset = 0;
+  for (size_t i = 0; i < input_strides.size(); ++i) {
+    src_offset += static_cast<std::ptrdiff_t>(compute_metadata.starts_[i] * input_strides[i]);
+    src_strides[i] = compute_metadata.steps_[i] * input_strides[i];
   }
 
+  // use MutableDataRaw as actual data type in tensor may not match as we templatize on data size
+  StridedCopy<T>(ctx->GetOperatorThreadPool(),
+                 reinterpret_cast<T*>(output_tensor.MutableDataRaw()), StridesForTensor(output_tensor), output_shape,
+                 reinterpret_cast<const T*>(input_tensor.DataRaw()) + src_offset, src_strides);
+
   return Status::OK();
 }
 
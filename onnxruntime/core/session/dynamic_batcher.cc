@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsCpuTensor(const OrtValue& value) {
+  return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+}
+
+// copy `num_rows` rows starting at `src_row` of `src` into `dst` starting at `dst_row`.
+// `src` and `dst` must have the same element type and per-row shape.
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t num_rows) {
+  const int64_t elements_per_row = src.Shape().SizeFromDimension(1);
+  const int64_t num_elements = num_rows * elements_per_row;
+  if (num_elements == 0) {
+    return;
+  }
+
+  if (src.IsDataTypeString()) {
+    const std::string* src_data = src.Data<std::string>() + src_row * elements_per_row;
+    std::string* dst_data = dst.MutableData<std::string>() + dst_row * elements_per_row;
+    std::copy(src_data, src_data + num_elements, dst_data);
+  } else {
+    const size_t element_size = src.DataType()->Size();
+    const auto* src_data = static_cast<const uint8_t*>(src.DataRaw()) + src_row * elements_per_row * element_size;
+    auto* dst_data = static_cast<uint8_t*>(dst.MutableDataRaw()) + dst_row * elements_per_row * element_size;
+    memcpy(dst_data, src_data, static_cast<size_t>(num_elements) * element_size);
+  }
+}
+
+Status TerminatedStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+}
+
+// strings are length prefixed so that no two different sets of values produce the same key
+void AppendKeyString(std::ostringstream& key, const std::string& value) {
+  key << value.size() << ':' << value;
+}
+
+TensorShape ShapeWithRows(const TensorShape& shape, int64_t num_rows) {
+  TensorShapeVector dims = shape.AsShapeVector();
+  dims[0] = num_rows;
+  return TensorShape(dims);
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(const DynamicBatchingOptions& options, AllocatorPtr cpu_allocator, RunFn run_fn)
+    : options_(options), cpu_allocator_(std::move(cpu_allocator)), run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(options_.max_batch_size > 1, "max_batch_size must be greater than 1 to enable dynamic batching.");
+  ORT_ENFORCE(options_.max_wait_us >= 0, "max_wait_us must not be negative.");
+  ORT_ENFORCE(cpu_allocator_ != nullptr && run_fn_, "A CPU allocator and run function are required.");
+}
+
+bool DynamicBatcher::CanBatch(const RunOptions& run_options, const std::vector<OrtValue>& feeds,
+                              const std::vector<OrtValue>& fetches) {
+  if (feeds.empty() || run_options.terminate) {
+    return false;
+  }
+
+  // pre-allocated fetches would need to be sliced out of the batched output, which we don't support
+  for (const auto& fetch : fetches) {
+    if (fetch.IsAllocated()) {
+      return false;
+    }
+  }
+
+  int64_t num_rows = -1;
+  for (const auto& feed : feeds) {
+    if (!IsCpuTensor(feed)) {
+      return false;
+    }
+
+    const auto& shape = feed.Get<Tensor>().Shape();
+    if (shape.NumDimensions() == 0 || shape[0] <= 0 || (num_rows != -1 && shape[0] != num_rows)) {
+      return false;
+    }
+
+    num_rows = shape[0];
+  }
+
+  return true;
+}
+
+std::string DynamicBatcher::GetBatchKey(const RunOptions& run_options,
+                                        const std::vector<std::string>& feed_names,
+                                        const std::vector<OrtValue>& feeds,
+                                        const std::vector<std::string>& output_names) {
+  std::ostringstream key;
+
+  // the batch runs with the options of one of its requests, so they must agree on everything but terminate, which
+  // is checked per request
+  key << run_options.run_log_severity_level << ',' << run_options.run_log_verbosity_level << ','
+      << run_options.only_execute_path_to_fetches << ',';
+#ifdef ENABLE_TRAINING
+  key << run_options.training_mode << ',';
+#endif
+  AppendKeyString(key, run_options.run_tag);
+  const std::map<std::string, std::string> configurations(run_options.config_options.configurations.cbegin(),
+                                                          run_options.config_options.configurations.cend());
+  for (const auto& entry : configurations) {
+    key << ',';
+    AppendKeyString(key, entry.first);
+    AppendKeyString(key, entry.second);
+  }
+  for (size_t i = 0, end = feed_names.size(); i < end; ++i) {
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const auto dims = tensor.Shape().GetDims();
+    key << '|' << feed_names[i] << ':' << tensor.GetElementType();
+    for (size_t d = 1; d < dims.size(); ++d) {
+      key << ',' << dims[d];
+    }
+  }
+
+  key << "->";
+  for (const auto& output_name : output_names) {
+    key << output_name << '|';
+  }
+
+  return key.str();
+}
+
+Status DynamicBatcher::Run(const RunOptions& run_options,
+                           const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                           const std::vector<std::string>& output_names, std::vector<OrtValue>& fetches) {
+  const int64_t num_rows = feeds.front().Get<Tensor>().Shape()[0];
+  if (static_cast<size_t>(num_rows) >= options_.max_batch_size) {
+    // already a full batch
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  Request request{&run_options, &feeds, &fetches, num_rows, Status::OK()};
+  const std::string key = GetBatchKey(run_options, feed_names, feeds, output_names);
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+
+  auto entry = open_batches_.find(key);
+  if (entry != open_batches_.end()) {
+    std::shared_ptr<Batch> batch = entry->second;
+    if (batch->num_rows + num_rows <= options_.max_batch_size) {
+      // join the batch and wait for its leader to execute it
+      batch->requests.push_back(&request);
+      batch->num_rows += num_rows;
+      if (batch->num_rows == options_.max_batch_size) {
+        open_batches_.erase(entry);
+        batch->closed = true;
+        batch->cv.notify_all();
+      }
+
+      batch->cv.wait(lock, [&batch]() { return batch->done; });
+      return request.status;
+    }
+
+    // the open batch doesn't have room for this request. close it so this request can start a new one.
+    batch->closed = true;
+    batch->cv.notify_all();
+  }
+
+  // start a new batch with this request as the leader
+  auto batch = std::make_shared<Batch>();
+  batch->requests.push_back(&request);
+  batch->num_rows = num_rows;
+  open_batches_[key] = batch;
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(options_.max_wait_us);
+  while (!batch->closed) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      break;
+    }
+
+    batch->cv.wait_for(lock, deadline - now);
+  }
+
+  if (!batch->closed) {
+    batch->closed = true;
+    auto cur = open_batches_.find(key);
+    if (cur != open_batches_.end() && cur->second == batch) {
+      open_batches_.erase(cur);
+    }
+  }
+
+  // the batch is closed so its requests are no longer modified by other threads
+  const std::vector<Request*> requests = batch->requests;
+  lock.unlock();
+
+  // the followers are blocked until `done` is set, so nothing may escape between here and there
+  ExecuteRequests(feed_names, output_names, requests);
+
+  lock.lock();
+  batch->done = true;
+  batch->cv.notify_all();
+
+  return request.status;
+}
+
+void DynamicBatcher::ExecuteRequests(const std::vector<std::string>& feed_names,
+                                     const std::vector<std::string>& output_names,
+                                     const std::vector<Request*>& requests) {
+  // requests that were terminated while waiting for the batch to fill are not run at all
+  std::vector<Request*> active;
+  size_t num_rows = 0;
+  for (auto* r : requests) {
+    if (r->run_options->terminate) {
+      r->status = TerminatedStatus();
+    } else {
+      active.push_back(r);
+      num_rows += static_cast<size_t>(r->num_rows);
+    }
+  }
+
+  if (active.empty()) {
+    return;
+  }
+
+  // all the requests have the same options apart from terminate, which the first one still running provides
+  const RunOptions& run_options = *active.front()->run_options;
+  Status status;
+  ORT_TRY {
+    if (active.size() == 1) {
+      status = run_fn_(run_options, feed_names, *active.front()->feeds, output_names, *active.front()->fetches);
+    } else {
+      status = ExecuteBatch(run_options, feed_names, output_names, active, num_rows);
+    }
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception executing dynamic batch: ", e.what());
+    });
+  }
+
+  for (auto* r : active) {
+    if (!status.IsOK()) {
+      r->status = status;
+    } else if (r->run_options->terminate) {
+      // the shared run could not be stopped for one request, so its results are dropped instead
+      r->fetches->clear();
+      r->status = TerminatedStatus();
+    }
+  }
+}
+
+Status DynamicBatcher::ExecuteBatch(const RunOptions& run_options,
+                                    const std::vector<std::string>& feed_names,
+                                    const std::vector<std::string>& output_names,
+                                    const std::vector<Request*>& requests, size_t num_rows) {
+  const int64_t total_rows = static_cast<int64_t>(num_rows);
+
+  // concatenate the feeds along dim 0
+  std::vector<OrtValue> batched_feeds(feed_names.size());
+  for (size_t i = 0, end = feed_names.size(); i < end; ++i) {
+    const auto& first = (*requests.front()->feeds)[i].Get<Tensor>();
+    Tensor::InitOrtValue(first.DataType(), ShapeWithRows(first.Shape(), total_rows), cpu_allocator_,
+                         batched_feeds[i]);
+    auto& batched = *batched_feeds[i].GetMutable<Tensor>();
+
+    int64_t row = 0;
+    for (const auto* request : requests) {
+      CopyRows((*request->feeds)[i].Get<Tensor>(), 0, batched, row, request->num_rows);
+      row += request->num_rows;
+    }
+  }
+
+  std::vector<OrtValue> batched_fetches;
+  ORT_RETURN_IF_ERROR(run_fn_(run_options, feed_names, batched_feeds, output_names, batched_fetches));
+
+  for (const auto& fetch : batched_fetches) {
+    ORT_RETURN_IF_NOT(IsCpuTensor(fetch), "Dynamic batching requires all outputs to be tensors in CPU memory.");
+    const auto& shape = fetch.Get<Tensor>().Shape();
+    ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == total_rows,
+                      "Dynamic batching requires all outputs to have the batch size as dim 0. Expected ",
+                      total_rows, " rows but got output with shape ", shape);
+  }
+
+  // split the fetches back to the requests
+  int64_t row = 0;
+  for (auto* request : requests) {
+    auto& fetches = *request->fetches;
+    fetches.resize(batched_fetches.size());
+    for (size_t i = 0, end = batched_fetches.size(); i < end; ++i) {
+      const auto& batched = batched_fetches[i].Get<Tensor>();
+      Tensor::InitOrtValue(batched.DataType(), ShapeWithRows(batched.Shape(), request->num_rows), cpu_allocator_,
+                           fetches[i]);
+      CopyRows(batched, row, *fetches[i].GetMutable<Tensor>(), 0, request->num_rows);
+    }
+
+    row += request->num_rows;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct DynamicBatchingOptions {
+  // Maximum number of rows (the sum of dim 0 across the requests) in a batched run.
+  size_t max_batch_size = 0;
+  // Maximum time in microseconds the first request of a batch waits for other requests to join it.
+  int64_t max_wait_us = 0;
+};
+
+/**
+ * Combines concurrent Run requests into a single batched run.
+ *
+ * Requests with the same feed names, output names, element types, per-row shapes and run options (other than the
+ * terminate flag) are concatenated along dim 0, run once, and the fetches are split back along dim 0 to each caller. The first request of a batch acts as the
+ * leader: it waits until either max_batch_size rows have been collected or max_wait_us has elapsed, then executes
+ * the batch on behalf of all the requests in it. Subsequent requests that arrive while the batch is executing form
+ * the next batch, so no extra threads are required.
+ *
+ * Batched runs go through the regular InferenceSession::Run path, so they use the session's FeedsFetchesManager
+ * handling, execution plan and memory patterns like any other run of the batched shape.
+ */
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<common::Status(const RunOptions& run_options,
+                                             const std::vector<std::string>& feed_names,
+                                             const std::vector<OrtValue>& feeds,
+                                             const std::vector<std::string>& output_names,
+                                             std::vector<OrtValue>& fetches)>;
+
+  /**
+   * @param options batching limits. max_batch_size must be greater than 1.
+   * @param cpu_allocator allocator used for the concatenated feeds and the split fetches.
+   * @param run_fn executes a (batched) request.
+   */
+  DynamicBatcher(const DynamicBatchingOptions& options, AllocatorPtr cpu_allocator, RunFn run_fn);
+
+  /**
+   * Returns true if the request can be combined with other requests. Requests that cannot be batched should be
+   * run directly.
+   */
+  static bool CanBatch(const RunOptions& run_options, const std::vector<OrtValue>& feeds,
+                       const std::vector<OrtValue>& fetches);
+
+  /**
+   * Run the request as part of a batch. Blocks until the batch containing the request has completed.
+   */
+  common::Status Run(const RunOptions& run_options,
+                     const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>& fetches);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    const RunOptions* run_options;
+    const std::vector<OrtValue>* feeds;
+    std::vector<OrtValue>* fetches;
+    int64_t num_rows;
+    common::Status status;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    size_t num_rows = 0;
+    bool closed = false;  // no more requests may join
+    bool done = false;    // fetches and status of each request have been set
+    OrtCondVar cv;
+  };
+
+  static std::string GetBatchKey(const RunOptions& run_options,
+                                 const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                 const std::vector<std::string>& output_names);
+
+  common::Status ExecuteBatch(const RunOptions& run_options,
+                              const std::vector<std::string>& feed_names,
+                              const std::vector<std::string>& output_names,
+                              const std::vector<Request*>& requests, size_t num_rows);
+
+  // Run the requests of a closed batch. Requests whose terminate flag is set before or during the run fail with
+  // the same status as a terminated Run, the others get their share of the fetches or the error of the run.
+  void ExecuteRequests(const std::vector<std::string>& feed_names, const std::vector<std::string>& output_names,
+                       const std::vector<Request*>& requests);
+
+  const DynamicBatchingOptions options_;
+  AllocatorPtr cpu_allocator_;
+  RunFn run_fn_;
+
+  OrtMutex mutex_;
+  // batches that are still accepting requests, keyed by GetBatchKey
+  std::unordered_map<std::string, std::shared_ptr<Batch>> open_batches_;
+};
+
+}  // namespace onnxruntime
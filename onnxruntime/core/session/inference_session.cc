@@ -265,6 +265,14 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 
   use_per_session_threads_ = session_options.use_per_session_threads;
 
+  const std::string numa_node_str = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaNode, "-1");
+  ORT_ENFORCE(TryParseStringWithClassicLocale(numa_node_str, numa_node_) && numa_node_ >= -1,
+              "Invalid value for ", kOrtSessionOptionsConfigNumaNode, ": ", numa_node_str);
+  if (numa_node_ >= 0 && !use_per_session_threads_) {
+    LOGS(*session_logger_, WARNING) << "The global thread pools are not bound to NUMA node " << numa_node_
+                                    << ". Only the memory of the session is.";
+  }
+
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
     {
@@ -289,6 +297,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.allow_spinning = allow_intra_op_spinning;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
+        to.numa_node = numa_node_;
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
@@ -322,6 +331,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.set_denormal_as_zero = set_denormal_as_zero;
         to.allow_spinning = allow_inter_op_spinning;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
+        to.numa_node = numa_node_;
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
@@ -1273,6 +1283,7 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.numa_node = numa_node_;
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
@@ -1474,6 +1485,10 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(ReserveArenaMemory());
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(CreateDynamicBatcher());
+
     is_inited_ = true;
 
     // we don't directly use the ORT format bytes currently, so free those now
@@ -1813,6 +1828,18 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
                              const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  if (dynamic_batcher_ && p_fetches != nullptr && p_fetches_device_info == nullptr &&
+      DynamicBatcher::CanBatch(run_options, feeds, *p_fetches)) {
+    return dynamic_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds,
+                                 const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -1968,7 +1995,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
     LOGS(*session_logger_, INFO) << "Start the second Run() to capture the graph. "
                                     "The first one is for necessary memory allocation;"
                                     "The second one is for capturing the graph.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
   }
   return retval;
 }
@@ -2070,6 +2097,53 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  ORT_RETURN_IF_NOT(callback, "A callback must be provided to RunAsync.");
+
+  // prefer the inter-op pool so the intra-op threads stay available to the kernels of the queued run
+  concurrency::ThreadPool* tp = GetInterOpThreadPoolToUse();
+  if (tp == nullptr) {
+    tp = GetIntraOpThreadPoolToUse();
+  }
+
+  // ThreadPool::Schedule runs the function inline when there are no worker threads, which would make the call
+  // blocking and could re-enter the callback before the caller has returned from RunAsync.
+  ORT_RETURN_IF(concurrency::ThreadPool::DegreeOfParallelism(tp) < 2,
+                "RunAsync requires a thread pool with at least one worker thread. "
+                "Set the inter-op or intra-op thread count to a value other than 1.");
+
+  // the lambda owns copies of everything it needs so that the caller's buffers can go out of scope
+  // as soon as RunAsync returns
+  auto run_fn = [this, run_options_copy = run_options, feed_names = std::move(feed_names),
+                 feeds = std::move(feeds), output_names = std::move(output_names), fetches = std::move(fetches),
+                 callback = std::move(callback)]() mutable {
+    Status status;
+    ORT_TRY {
+      status = Run(run_options_copy, feed_names, feeds, output_names, &fetches);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+      });
+    }
+    ORT_CATCH(...) {
+      status = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in RunAsync()");
+    }
+
+    callback(status, fetches);
+  };
+
+  concurrency::ThreadPool::Schedule(tp, std::move(run_fn));
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -2112,6 +2186,121 @@ AllocatorPtr InferenceSession::GetAllocator(const OrtMemoryInfo& mem_info) const
   return session_state_->GetAllocator(mem_info);
 }
 
+common::Status InferenceSession::CreateDynamicBatcher() {
+  const auto& config_options = session_options_.config_options;
+  size_t max_batch_size = 0;
+  const std::string max_batch_size_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_batch_size_str, max_batch_size),
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, ": ",
+                    max_batch_size_str);
+
+  if (max_batch_size <= 1) {
+    return Status::OK();
+  }
+
+  int64_t max_wait_us = 0;
+  const std::string max_wait_us_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxWaitUs, "1000");
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_wait_us_str, max_wait_us) && max_wait_us >= 0,
+                    "Invalid value for ", kOrtSessionOptionsConfigDynamicBatchingMaxWaitUs, ": ", max_wait_us_str);
+
+  // the batch dim must not be fixed for any graph input or output, otherwise the batched run will fail
+  const auto has_fixed_batch_dim = [](const NodeArg* node_arg) {
+    const auto* shape = node_arg->Shape();
+    return shape != nullptr && (shape->dim_size() == 0 || utils::HasDimValue(shape->dim(0)));
+  };
+
+  const Graph& graph = model_->MainGraph();
+  for (const auto* input : graph.GetInputs()) {
+    ORT_RETURN_IF(has_fixed_batch_dim(input), "Dynamic batching requires a symbolic dim 0 for all graph inputs. Input '",
+                  input->Name(), "' has a fixed dim 0 or is a scalar.");
+  }
+
+  for (const auto* output : graph.GetOutputs()) {
+    ORT_RETURN_IF(has_fixed_batch_dim(output), "Dynamic batching requires a symbolic dim 0 for all graph outputs. "
+                  "Output '", output->Name(), "' has a fixed dim 0 or is a scalar.");
+  }
+
+  DynamicBatchingOptions options;
+  options.max_batch_size = max_batch_size;
+  options.max_wait_us = max_wait_us;
+
+  auto cpu_allocator = session_state_->GetAllocator(OrtDevice());
+  ORT_RETURN_IF(cpu_allocator == nullptr, "Dynamic batching requires a CPU allocator.");
+
+  dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+      options, std::move(cpu_allocator),
+      [this](const RunOptions& run_options, const std::vector<std::string>& feed_names,
+             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+             std::vector<OrtValue>& fetches) {
+        return RunImpl(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+      });
+
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with max batch size " << max_batch_size
+                               << " and max wait of " << max_wait_us << "us.";
+  return Status::OK();
+}
+
+common::Status InferenceSession::ReserveArenaMemory() {
+  const std::string shape_sets_str =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigArenaReserveInputShapes, "");
+  if (shape_sets_str.empty()) {
+    return Status::OK();
+  }
+
+  // largest peak over the shape sets for each location
+  std::map<OrtMemoryInfo, size_t> peak_sizes;
+
+  std::istringstream shape_sets(shape_sets_str);
+  std::string shape_set;
+  while (std::getline(shape_sets, shape_set, '|')) {
+    std::map<std::string, TensorShape> input_shapes;
+
+    std::istringstream inputs(shape_set);
+    std::string input;
+    while (std::getline(inputs, input, ';')) {
+      const auto separator = input.rfind(':');
+      ORT_RETURN_IF(separator == std::string::npos || separator == 0,
+                    "Invalid input shape in ", kOrtSessionOptionsConfigArenaReserveInputShapes, ": ", input);
+
+      TensorShapeVector dims;
+      std::istringstream dims_stream(input.substr(separator + 1));
+      std::string dim_str;
+      while (std::getline(dims_stream, dim_str, ',')) {
+        int64_t dim = 0;
+        ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(dim_str, dim) && dim >= 0,
+                          "Invalid dim in ", kOrtSessionOptionsConfigArenaReserveInputShapes, ": ", input);
+        dims.push_back(dim);
+      }
+
+      input_shapes[input.substr(0, separator)] = TensorShape(dims);
+    }
+
+    std::map<OrtMemoryInfo, size_t> set_peak_sizes;
+    ORT_RETURN_IF_ERROR(session_state_->ComputePeakActivationMemory(input_shapes, set_peak_sizes));
+    for (const auto& peak_size : set_peak_sizes) {
+      auto& size = peak_sizes[peak_size.first];
+      size = std::max(size, peak_size.second);
+    }
+  }
+
+  for (const auto& peak_size : peak_sizes) {
+    auto alloc = session_state_->GetAllocator(peak_size.first);
+    if (alloc == nullptr || alloc->Info().alloc_type != OrtAllocatorType::OrtArenaAllocator) {
+      LOGS(*session_logger_, INFO) << "Not reserving " << peak_size.second << " bytes for "
+                                   << peak_size.first.ToString() << " as it is not an arena based allocator.";
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(static_cast<BFCArena*>(alloc.get())->ReserveRegion(peak_size.second));
+    LOGS(*session_logger_, INFO) << "Reserved " << peak_size.second << " bytes in the arena for "
+                                 << alloc->Info().ToString();
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::ValidateAndParseShrinkArenaString(const std::string& ort_device_list,
                                                                    /*out*/ std::vector<AllocatorPtr>& arenas_to_shrink) const {
   arenas_to_shrink.reserve(5);  // Allocate some memory for the container (we are unlikely to see more than 5 memory arena shrink requests)
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -23,6 +24,7 @@
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/framework/session_options.h"
 #include "core/framework/allocatormgr.h"
+#include "core/session/dynamic_batcher.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
 #endif
@@ -338,6 +340,22 @@ class InferenceSession {
   virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding) ORT_MUST_USE_RESULT;
   common::Status Run(IOBinding& io_binding) ORT_MUST_USE_RESULT;
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * Queue a Run of a pre-loaded and pre-initialized model and return without waiting for it to complete.
+   * The run is executed on the inter-op thread pool, or on the intra-op thread pool if the session has no
+   * inter-op thread pool (i.e. it is using the sequential executor).
+   * @param run_options options for the run. Copied, so changes made after this call have no effect on the run.
+   * @param fetches pre-allocated output values, or empty OrtValue instances for outputs to be allocated by the run.
+   * @param callback invoked on a thread pool thread once the run completes, with the run status and the fetches.
+   *        The session must not be destroyed until every queued callback has been invoked.
+   * @return OK if the run was queued. The status of the run itself is reported via the callback.
+   */
+  common::Status RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback) ORT_MUST_USE_RESULT;
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -585,6 +603,18 @@ class InferenceSession {
 
   common::Status LoadOrtModel(std::function<Status()> load_ort_format_model_bytes) ORT_MUST_USE_RESULT;
 
+  // Run the model without going through the dynamic batcher.
+  common::Status RunImpl(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                         const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                         std::vector<OrtValue>* p_fetches,
+                         const std::vector<OrtDevice>* p_fetches_device_info) ORT_MUST_USE_RESULT;
+
+  // Create dynamic_batcher_ if dynamic batching is enabled in the session options.
+  common::Status CreateDynamicBatcher() ORT_MUST_USE_RESULT;
+
+  // Extend the memory arenas by the peak activation memory of the input shapes listed in the session options.
+  common::Status ReserveArenaMemory() ORT_MUST_USE_RESULT;
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -672,6 +702,9 @@ class InferenceSession {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Combines concurrent Run calls into batched runs. Only set if dynamic batching is enabled.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
@@ -686,6 +719,9 @@ class InferenceSession {
   // If true, use the per session ones, or else the global threadpools.
   bool use_per_session_threads_;
 
+  // NUMA node the session is bound to, or -1. initialized from session options.
+  int numa_node_ = -1;
+
   KernelRegistryManager kernel_registry_manager_;
 
 #if !defined(ORT_MINIMAL_BUILD)
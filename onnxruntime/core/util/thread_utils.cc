@@ -22,7 +22,24 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   if (options.affinity_vec_len != 0) {
     to.affinity.assign(options.affinity_vec, options.affinity_vec + options.affinity_vec_len);
   }
-  if (options.thread_pool_size <= 0) {  // default
+  if (options.numa_node >= 0) {
+    const auto numa_nodes = Env::Default().GetNumaNodeThreadAffinityMasks();
+    ORT_ENFORCE(static_cast<size_t>(options.numa_node) < numa_nodes.size() &&
+                    !numa_nodes[options.numa_node].empty(),
+                "NUMA node ", options.numa_node, " is not available. Number of NUMA nodes: ", numa_nodes.size());
+    const auto& node_processors = numa_nodes[options.numa_node];
+    if (options.thread_pool_size <= 0) {
+      options.thread_pool_size = static_cast<int>(node_processors.size());
+    }
+    if (options.thread_pool_size == 1)
+      return nullptr;
+
+    // one processor per thread, wrapping around if there are more threads than processors on the node
+    to.affinity.resize(options.thread_pool_size);
+    for (size_t i = 0; i < to.affinity.size(); ++i) {
+      to.affinity[i] = node_processors[i % node_processors.size()];
+    }
+  } else if (options.thread_pool_size <= 0) {  // default
     cpu_list = Env::Default().GetThreadAffinityMasks();
     if (cpu_list.empty() || cpu_list.size() == 1)
       return nullptr;
@@ -27,6 +27,9 @@ struct OrtThreadPoolParams {
   //If the vector is empty, no explict affinity binding
   size_t* affinity_vec = nullptr;
   size_t affinity_vec_len = 0;
+  //If it is non-negative, the threads are bound to the processors of this NUMA node, and a thread_pool_size of 0
+  //creates one thread per processor of the node. Takes precedence over affinity_vec and auto_set_affinity.
+  int numa_node = -1;
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
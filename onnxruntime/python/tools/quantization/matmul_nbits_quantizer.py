@@ -0,0 +1,176 @@
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import argparse
+import logging
+
+import numpy as np
+import onnx
+from onnx import helper, numpy_helper
+
+from .onnx_model import ONNXModel
+from .quant_utils import ms_domain
+
+logger = logging.getLogger(__name__)
+
+
+def quantize_blockwise(fp32weight, bits=4, block_size=32, is_symmetric=False):
+    """
+    Quantize a 2D [K, N] float weight to the layout of the com.microsoft MatMulNBits operator.
+    Each column is split in blocks of block_size elements along K, and each block gets its own scale and zero point.
+    This follows MlasQNBitGemmQuantizeB so a model quantized here computes the same as the CPU kernel.
+    :return: packed data [N, n_blocks_per_col, blob_size], scales [N * n_blocks_per_col] and zero points (None when
+             symmetric) [N * ((n_blocks_per_col * bits + 7) // 8)]
+    """
+    if bits not in (4, 8):
+        raise ValueError("bits must be 4 or 8, got {}".format(bits))
+    if block_size < 16 or block_size > 256 or (block_size & (block_size - 1)) != 0:
+        raise ValueError("block_size must be a power of 2 in [16, 256], got {}".format(block_size))
+    if len(fp32weight.shape) != 2:
+        raise ValueError("weight must be 2D, got shape {}".format(fp32weight.shape))
+
+    k, n = fp32weight.shape
+    n_blocks = (k + block_size - 1) // block_size
+    q_max = (1 << bits) - 1
+    default_zp = 1 << (bits - 1)
+
+    padded = np.zeros((n_blocks * block_size, n), dtype=np.float32)
+    padded[:k, :] = fp32weight
+    blocks = np.ascontiguousarray(padded.T).reshape(n, n_blocks, block_size)
+
+    if is_symmetric:
+        # the value of largest magnitude maps to 0 so the whole quantized range is used
+        index = np.argmax(np.abs(blocks), axis=2)
+        abs_max = np.take_along_axis(blocks, index[..., np.newaxis], axis=2)[..., 0]
+        scales = (abs_max / np.float32(-default_zp)).astype(np.float32)
+        zero_points = np.full((n, n_blocks), default_zp, dtype=np.int32)
+    else:
+        v_min = np.minimum(blocks.min(axis=2), np.float32(0))
+        v_max = np.maximum(blocks.max(axis=2), np.float32(0))
+        scales = ((v_max - v_min) / np.float32(q_max)).astype(np.float32)
+        with np.errstate(divide="ignore", invalid="ignore"):
+            zero_points = np.where(scales != 0, np.rint(-v_min / scales), default_zp)
+        zero_points = np.clip(zero_points, 0, q_max).astype(np.int32)
+
+    with np.errstate(divide="ignore"):
+        reciprocal = np.where(scales != 0, np.float32(1) / scales, np.float32(0)).astype(np.float32)
+    quantized = np.rint(blocks * reciprocal[..., np.newaxis]) + zero_points[..., np.newaxis]
+    quantized = np.clip(quantized, 0, q_max).astype(np.uint8)
+
+    # padding past K is stored as 0
+    valid = (np.arange(n_blocks * block_size) < k).reshape(n_blocks, block_size)
+    quantized = np.where(valid[np.newaxis, ...], quantized, np.uint8(0)).astype(np.uint8)
+
+    if bits == 4:
+        packed = quantized[..., 0::2] | (quantized[..., 1::2] << 4)
+    else:
+        packed = quantized
+
+    packed_zero_points = None
+    if not is_symmetric:
+        zp = zero_points.astype(np.uint8)
+        if bits == 4:
+            if n_blocks % 2 != 0:
+                zp = np.concatenate([zp, np.zeros((n, 1), dtype=np.uint8)], axis=1)
+            zp = zp[:, 0::2] | (zp[:, 1::2] << 4)
+        packed_zero_points = zp.reshape(-1)
+
+    return packed.astype(np.uint8), scales.reshape(-1), packed_zero_points
+
+
+class MatMulNBitsQuantizer:
+    """
+    Weight only quantization of MatMul nodes: every MatMul whose second input is a 2D float initializer is replaced by
+    a com.microsoft MatMulNBits node holding the weight quantized blockwise to 4 or 8 bits. Activations stay float.
+    """
+
+    def __init__(self, model, block_size=32, bits=4, is_symmetric=False, nodes_to_exclude=None):
+        if nodes_to_exclude is None:
+            nodes_to_exclude = []
+        self.model = ONNXModel(onnx.load(model) if isinstance(model, str) else model)
+        self.block_size = block_size
+        self.bits = bits
+        self.is_symmetric = is_symmetric
+        self.nodes_to_exclude = set(nodes_to_exclude)
+
+    def _quantize_matmul(self, node):
+        if node.op_type != "MatMul" or node.name in self.nodes_to_exclude:
+            return node
+
+        b_tensor = self.model.get_initializer(node.input[1])
+        if b_tensor is None or b_tensor.data_type != onnx.TensorProto.FLOAT:
+            return node
+
+        b_array = numpy_helper.to_array(b_tensor)
+        if len(b_array.shape) != 2:
+            logger.info("MatMul {} weight is not 2D, skipped".format(node.name))
+            return node
+
+        packed, scales, zero_points = quantize_blockwise(b_array, self.bits, self.block_size, self.is_symmetric)
+
+        b_quant = numpy_helper.from_array(packed, b_tensor.name + "_Q{}".format(self.bits))
+        scales_tensor = numpy_helper.from_array(scales, b_tensor.name + "_scales")
+        self.model.add_initializer(b_quant)
+        self.model.add_initializer(scales_tensor)
+        inputs = [node.input[0], b_quant.name, scales_tensor.name]
+        if zero_points is not None:
+            zp_tensor = numpy_helper.from_array(zero_points, b_tensor.name + "_zero_points")
+            self.model.add_initializer(zp_tensor)
+            inputs.append(zp_tensor.name)
+
+        k, n = b_array.shape
+        return helper.make_node(
+            "MatMulNBits",
+            inputs=inputs,
+            outputs=list(node.output),
+            name=(node.name + "_Q{}".format(self.bits)) if node.name else "",
+            domain=ms_domain,
+            K=k,
+            N=n,
+            bits=self.bits,
+            block_size=self.block_size,
+        )
+
+    def process(self):
+        new_nodes = [self._quantize_matmul(node) for node in self.model.nodes()]
+        self.model.graph().ClearField("node")
+        self.model.graph().node.extend(new_nodes)
+
+        if not any(opset.domain == ms_domain for opset in self.model.opset_import()):
+            self.model.opset_import().extend([helper.make_opsetid(ms_domain, 1)])
+
+        self.model.remove_unused_constant()
+        return self.model.model
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="Quantize the weights of the MatMul nodes of a float model to 4 or 8 bits with blockwise scales. "
+        "The activations are not quantized."
+    )
+    parser.add_argument("--input_model", required=True, help="Path to the input model file")
+    parser.add_argument("--output_model", required=True, help="Path to the output model file")
+    parser.add_argument("--block_size", required=False, default=32, type=int, help="Block size for quantization")
+    parser.add_argument("--bits", required=False, default=4, type=int, choices=[4, 8], help="Bits of the weights")
+    parser.add_argument(
+        "--symmetric", required=False, default=False, action="store_true", help="Quantize without zero points"
+    )
+    parser.add_argument(
+        "--nodes_to_exclude", nargs="+", type=str, required=False, default=[], help="Names of nodes to keep in float"
+    )
+    parser.add_argument(
+        "--use_external_data_format", required=False, default=False, action="store_true", help="Save large models"
+    )
+    return parser.parse_args()
+
+
+if __name__ == "__main__":
+    args = parse_args()
+    quantizer = MatMulNBitsQuantizer(
+        args.input_model, args.block_size, args.bits, args.symmetric, args.nodes_to_exclude
+    )
+    quantizer.process()
+    quantizer.model.save_model_to_file(args.output_model, args.use_external_data_format)
@@ -6,6 +6,8 @@
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/scoped_env_vars.h"
+#include "contrib_ops/cpu/bert/attention_base.h"
 
 namespace onnxruntime {
 namespace test {
@@ -162,6 +164,15 @@ static void RunAttentionTest(
       std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
       execution_providers.push_back(DefaultCpuExecutionProvider());
       tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+
+      // Run again with the tiled attention, which is otherwise only used for long sequences.
+      ScopedEnvironmentVariables scoped_env_vars{
+          EnvVarMap{
+              {onnxruntime::contrib::attention::kMinimumTiledScoreSize, "1"},
+          }};
+      execution_providers.clear();
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
     }
   }
 }
@@ -823,6 +834,135 @@ TEST(AttentionTest, AttentionPastStateBatch1) {
                    use_past_state, past_sequence_length, &past_data, &present_data);
 }
 
+TEST(AttentionTest, AttentionPastStateSharedBuffer) {
+  int batch_size = 1;
+  int sequence_length = 1;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+  int head_size = hidden_size / number_of_heads;
+  int past_sequence_length = 3;
+  int max_sequence_length = 5;
+
+  std::vector<float> input_data = {
+      -0.019333266f, -0.21813886f, 0.16212955f, -0.015626367f};
+
+  std::vector<float> weight_data = {
+      -0.4738484025001526f,
+      -0.2613658607006073f,
+      -0.0978037416934967f,
+      -0.34988933801651f,
+      0.2243240624666214f,
+      -0.0429205559194088f,
+      0.418695330619812f,
+      0.17441125214099884f,
+      -0.18825532495975494f,
+      0.18357256054878235f,
+      -0.5806483626365662f,
+      -0.02251487597823143f,
+
+      0.08742205798625946f,
+      0.14734269678592682f,
+      0.2387014478445053f,
+      0.2884027063846588f,
+      0.6490834355354309f,
+      0.16965825855731964f,
+      -0.06346885114908218f,
+      0.4073973298072815f,
+      -0.03070945478975773f,
+      0.4110257923603058f,
+      0.07896808534860611f,
+      0.16783113777637482f,
+
+      0.0038893644232302904f,
+      0.06946629285812378f,
+      0.36680519580841064f,
+      -0.07261059433221817f,
+      -0.14960581064224243f,
+      0.020944256335496902f,
+      -0.09378612786531448f,
+      -0.1336742341518402f,
+      0.06061394885182381f,
+      0.2205914407968521f,
+      -0.03519909828901291f,
+      -0.18405692279338837f,
+
+      0.22149960696697235f,
+      -0.1884360909461975f,
+      -0.014074507169425488f,
+      0.4252440333366394f,
+      0.24987126886844635f,
+      -0.31396418809890747f,
+      0.14036843180656433f,
+      0.2854192554950714f,
+      0.09709841012954712f,
+      0.09935075044631958f,
+      -0.012154420837759972f,
+      0.2575816512107849f};
+
+  std::vector<float> bias_data = {
+      0.4803391396999359f,
+      -0.5254325866699219f,
+      -0.42926454544067383f,
+      -0.2059524953365326f,
+      -0.12773379683494568f,
+      -0.09542735666036606f,
+      -0.35286077857017517f,
+      -0.07646317780017853f,
+      -0.04590314254164696f,
+      -0.03752850368618965f,
+      -0.013764488510787487f,
+      -0.18478283286094666f};
+
+  std::vector<float> output_data = {
+      0.20141591f, 0.43005896f, 0.35745093f, 0.19957167f};
+
+  std::vector<float> past_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f};
+
+  std::vector<float> present_data = {
+      0.55445826f, 0.10127074f, 0.71770734f, 0.15915526f, 0.13913247f, 0.77447522f, -0.30182117f, -0.12330482f, 0.66044068f, 0.27559045f, 0.35731629f, 0.62033528f, 0.24354559f, 0.22859341f, -0.36450946f, -0.19483691f,
+      0.45075402f, 0.85365993f, 0.097346395f, 0.28859729f, 0.26926181f, 0.65922296f, -0.027254611f, -0.096526355f, 0.8177433f, 0.4212271f, 0.34352475f, 0.059609573f, 0.46556228f, 0.7226882f, -0.025281552f, -0.25482416f};
+
+  // Copy rows of each (key or value, head) chunk into a buffer of max_sequence_length rows. Unused rows are filled
+  // with a value that shall not affect the result.
+  auto pad_state = [&](const std::vector<float>& state, int state_sequence_length) {
+    std::vector<float> padded(static_cast<size_t>(2 * batch_size * number_of_heads * max_sequence_length * head_size), 9.f);
+    for (int chunk = 0; chunk < 2 * batch_size * number_of_heads; chunk++) {
+      std::copy_n(state.begin() + chunk * state_sequence_length * head_size,
+                  state_sequence_length * head_size,
+                  padded.begin() + chunk * max_sequence_length * head_size);
+    }
+    return padded;
+  };
+
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims = {3 * hidden_size};
+  std::vector<int64_t> state_dims = {2, batch_size, number_of_heads, max_sequence_length, head_size};
+  std::vector<int64_t> output_dims = {batch_size, sequence_length, hidden_size};
+
+  OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddAttribute<int64_t>("unidirectional", static_cast<int64_t>(1));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+  tester.AddInput<float>("input", input_dims, input_data);
+  tester.AddInput<float>("weight", weights_dims, weight_data);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("past", state_dims, pad_state(past_data, past_sequence_length));
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+
+  tester.AddOutput<float>("output", output_dims, output_data);
+  tester.AddOutput<float>("present", state_dims, pad_state(present_data, past_sequence_length + sequence_length));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(AttentionTest, AttentionPastStateBatch2) {
   int batch_size = 2;
   int sequence_length = 1;
@@ -1651,6 +1791,87 @@ TEST(AttentionTest, AttentionMaskIndexOutOfRange) {
                    use_float16, is_unidirectional, use_past_state, past_sequence_length, past_data, present_data, kMaskIndexEndAndStart);
 }
 
+// The tiled attention of the CPU kernel splits the query rows in blocks of 64 and the keys in blocks of 256, so with
+// S = 100 and S* = 400 there are partial blocks and several key blocks per row, which the short tests don't have.
+// Its outputs are compared with those of the kernel computing the whole attention probs.
+TEST(AttentionTest, AttentionTiledLongSequence) {
+  constexpr int batch_size = 2;
+  constexpr int sequence_length = 100;
+  constexpr int past_sequence_length = 300;
+  constexpr int all_sequence_length = past_sequence_length + sequence_length;
+  constexpr int hidden_size = 16;
+  constexpr int number_of_heads = 2;
+  constexpr int head_size = hidden_size / number_of_heads;
+
+  RandomValueGenerator random{};
+  std::vector<int64_t> input_dims{batch_size, sequence_length, hidden_size};
+  std::vector<float> input_data = random.Gaussian<float>(input_dims, 0.0f, 0.3f);
+  std::vector<int64_t> weight_dims{hidden_size, 3 * hidden_size};
+  std::vector<float> weight_data = random.Gaussian<float>(weight_dims, 0.0f, 0.3f);
+  std::vector<int64_t> bias_dims{3 * hidden_size};
+  std::vector<float> bias_data = random.Gaussian<float>(bias_dims, 0.0f, 0.3f);
+  std::vector<int64_t> past_dims{2, batch_size, number_of_heads, past_sequence_length, head_size};
+  std::vector<float> past_data = random.Gaussian<float>(past_dims, 0.0f, 0.3f);
+
+  // the second batch has padding at the start of the past and a masked span across the past and the input, which
+  // crosses the boundary of the first two key blocks
+  std::vector<int64_t> mask_dims{batch_size, all_sequence_length};
+  std::vector<int32_t> mask_data(static_cast<size_t>(batch_size) * all_sequence_length, 1);
+  std::fill_n(mask_data.begin() + all_sequence_length, 37, 0);
+  std::fill_n(mask_data.begin() + all_sequence_length + 250, 70, 0);
+
+  std::vector<int64_t> output_dims{batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> present_dims{2, batch_size, number_of_heads, all_sequence_length, head_size};
+
+  for (int64_t unidirectional : {0, 1}) {
+    OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+    tester.AddAttribute<int64_t>("unidirectional", unidirectional);
+    tester.AddInput<float>("input", input_dims, input_data);
+    tester.AddInput<float>("weight", weight_dims, weight_data);
+    tester.AddInput<float>("bias", bias_dims, bias_data);
+    tester.AddInput<int32_t>("mask_index", mask_dims, mask_data);
+    tester.AddInput<float>("past", past_dims, past_data);
+    // the expected values are not used, the outputs of the two runs are compared instead
+    tester.AddOutput<float>("output", output_dims,
+                            std::vector<float>(static_cast<size_t>(batch_size) * sequence_length * hidden_size));
+    tester.AddOutput<float>("present", present_dims,
+                            std::vector<float>(static_cast<size_t>(2) * batch_size * all_sequence_length * hidden_size));
+
+    std::vector<std::vector<float>> outputs;
+    tester.SetCustomOutputVerifier([&outputs](const std::vector<OrtValue>& fetches, const std::string&) {
+      for (const auto& fetch : fetches) {
+        auto data = fetch.Get<Tensor>().DataAsSpan<float>();
+        outputs.emplace_back(data.begin(), data.end());
+      }
+    });
+
+    const auto run_cpu = [&tester](const char* min_tiled_score_size) {
+      ScopedEnvironmentVariables scoped_env_vars{
+          EnvVarMap{
+              {onnxruntime::contrib::attention::kMinimumTiledScoreSize, min_tiled_score_size},
+          }};
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    };
+
+    run_cpu("1000000000");  // whole attention probs
+    run_cpu("1");           // tiled
+    ASSERT_EQ(outputs.size(), 4u);
+
+    for (size_t i = 0; i < 2; ++i) {
+      const auto& expected = outputs[i];
+      const auto& actual = outputs[i + 2];
+      ASSERT_EQ(expected.size(), actual.size());
+      for (size_t j = 0; j < expected.size(); ++j) {
+        ASSERT_NEAR(expected[j], actual[j], 1e-4f + 1e-4f * std::abs(expected[j]))
+            << "unidirectional=" << unidirectional << " output " << i << " index " << j;
+      }
+    }
+  }
+}
+
 #if !defined(__wasm__)
 // TODO: fix in web assembly
 TEST(AttentionTest, AttentionPastState_dynamic) {
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+
+namespace onnxruntime {
+namespace test {
+
+static void RunMatMulNBitsTest(const std::vector<int64_t>& A_dims, int64_t N, int64_t bits, int64_t block_size,
+                               bool has_zero_point, bool has_bias) {
+  const int64_t K = A_dims.back();
+  const int64_t M = std::accumulate(A_dims.begin(), A_dims.end() - 1, int64_t{1}, std::multiplies<int64_t>());
+
+  RandomValueGenerator random{};
+  std::vector<float> A_data = random.Uniform<float>(A_dims, -1.0f, 1.0f);
+  std::vector<float> B_data = random.Uniform<float>({K, N}, -1.0f, 1.0f);
+  std::vector<float> bias = random.Uniform<float>({N}, -1.0f, 1.0f);
+
+  size_t q_data_size;
+  size_t q_scale_count;
+  size_t q_zp_size;
+  MlasQNBitGemmQuantBSizes(static_cast<size_t>(N), static_cast<size_t>(K), static_cast<size_t>(bits),
+                           static_cast<size_t>(block_size), &q_data_size, &q_scale_count, &q_zp_size);
+
+  std::vector<uint8_t> q_data(q_data_size);
+  std::vector<float> scales(q_scale_count);
+  std::vector<uint8_t> zero_points(q_zp_size);
+  MlasQNBitGemmQuantizeB(static_cast<size_t>(N), static_cast<size_t>(K), static_cast<size_t>(bits),
+                         static_cast<size_t>(block_size), B_data.data(), static_cast<size_t>(N), q_data.data(),
+                         scales.data(), has_zero_point ? zero_points.data() : nullptr, nullptr);
+
+  // Dequantize B from the layout described in the operator spec.
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zp_stride = (blocks_per_col * bits + 7) / 8;
+  auto get_value = [bits](const uint8_t* buffer, int64_t index) -> int {
+    return bits == 4 ? (buffer[index / 2] >> ((index % 2) * 4)) & 0x0F : buffer[index];
+  };
+
+  std::vector<float> dequant_B(K * N);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t k = 0; k < K; k++) {
+      const int64_t block = k / block_size;
+      const int zp = has_zero_point ? get_value(zero_points.data() + n * zp_stride, block) : (1 << (bits - 1));
+      const int q = get_value(q_data.data() + (n * blocks_per_col + block) * blob_size, k % block_size);
+      dequant_B[k * N + n] = (q - zp) * scales[n * blocks_per_col + block];
+    }
+  }
+
+  std::vector<float> expected(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = has_bias ? bias[n] : 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += A_data[m * K + k] * dequant_B[k * N + n];
+      }
+      expected[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> Y_dims(A_dims);
+  Y_dims.back() = N;
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddInput<float>("A", A_dims, A_data);
+  test.AddInput<uint8_t>("B", {N, blocks_per_col, blob_size}, q_data, true);
+  test.AddInput<float>("scales", {static_cast<int64_t>(q_scale_count)}, scales, true);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {static_cast<int64_t>(q_zp_size)}, zero_points, true);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, bias, true);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddOutput<float>("Y", Y_dims, expected);
+  test.SetOutputAbsErr("Y", 1e-4f);
+  test.Run();
+}
+
+TEST(MatMulNBits, Float32_4Bits) {
+  for (int64_t block_size : {16, 32, 64, 128}) {
+    RunMatMulNBitsTest({1, 64}, 32, 4, block_size, true, false);
+    RunMatMulNBitsTest({1, 100}, 17, 4, block_size, false, true);
+    RunMatMulNBitsTest({2, 3, 300}, 40, 4, block_size, true, true);
+    RunMatMulNBitsTest({16, 129}, 64, 4, block_size, false, false);
+  }
+}
+
+TEST(MatMulNBits, Float32_8Bits) {
+  for (int64_t block_size : {16, 32, 128, 256}) {
+    RunMatMulNBitsTest({1, 64}, 32, 8, block_size, true, false);
+    RunMatMulNBitsTest({2, 3, 300}, 40, 8, block_size, false, true);
+    RunMatMulNBitsTest({16, 129}, 64, 8, block_size, true, true);
+  }
+}
+
+TEST(MatMulNBits, InvalidBlockSize) {
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", int64_t{32});
+  test.AddAttribute<int64_t>("N", int64_t{1});
+  test.AddAttribute<int64_t>("bits", int64_t{4});
+  test.AddAttribute<int64_t>("block_size", int64_t{24});
+  test.AddInput<float>("A", {1, 32}, std::vector<float>(32, 1.0f));
+  test.AddInput<uint8_t>("B", {1, 2, 12}, std::vector<uint8_t>(24, 0), true);
+  test.AddInput<float>("scales", {2}, {1.0f, 1.0f}, true);
+  test.AddOutput<float>("Y", {1, 1}, {0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "unsupported bits 4 or block_size 24");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
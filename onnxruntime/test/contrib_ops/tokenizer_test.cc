@@ -864,5 +864,37 @@ TEST(ContribOpTest, Tokenizer_EmptyInput) {
     test.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
+
+TEST(ContribOpTest, TokenizerWithSeparators_LargeBatchNC) {
+  // Enough rows for them to be tokenized in parallel. Every separator only
+  // occurs in some of the rows and tokens shorter than mincharnum are dropped.
+  std::vector<std::string> separators = {u8";", u8",", u8" "};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, true, separators, 2);
+
+  const std::vector<std::string> rows{u8"Абсу;中文", u8"a,bb cc", u8"x", u8"one two;three"};
+  const std::vector<std::vector<std::string>> row_tokens{
+      {u8"Абсу", u8"中文"}, {u8"bb", u8"cc"}, {}, {u8"one", u8"two", u8"three"}};
+  constexpr int64_t N = 500;
+  const int64_t C = static_cast<int64_t>(rows.size());
+  const int64_t max_tokens = 3 + 2;  // with start/end markers
+
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t n = 0; n < N; ++n) {
+    input.insert(input.end(), rows.cbegin(), rows.cend());
+    for (const auto& tokens : row_tokens) {
+      output.push_back(start_mark);
+      output.insert(output.end(), tokens.cbegin(), tokens.cend());
+      output.push_back(end_mark);
+      output.insert(output.end(), max_tokens - 2 - tokens.size(), padval);
+    }
+  }
+
+  test.AddInput<std::string>("T", {N, C}, input);
+  test.AddOutput<std::string>("Y", {N, C, max_tokens}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
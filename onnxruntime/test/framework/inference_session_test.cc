@@ -759,6 +759,175 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+// Y = A * B with no shape information so dim 0 is symbolic, in a session with dynamic batching enabled
+static void InitDynamicBatchingSession(InferenceSession& session_object) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& input_arg_a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& input_arg_b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("node1", "Mul", "Mul", {&input_arg_a, &input_arg_b}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+}
+
+// runs a single row request whose values are unique to i so we can check the fetches were split correctly
+static Status RunDynamicBatchingRequest(InferenceSession& session_object, const RunOptions& run_options, int i,
+                                        std::vector<OrtValue>& fetches) {
+  std::vector<float> a_values = {static_cast<float>(i), 2.f};
+  std::vector<float> b_values = {3.f, static_cast<float>(i)};
+  OrtValue a, b;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2}, a_values, &a);
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2}, b_values, &b);
+  return session_object.Run(run_options, {"A", "B"}, {a, b}, {"Y"}, &fetches);
+}
+
+TEST(InferenceSessionTests, DynamicBatching) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.DynamicBatching";
+  constexpr int num_requests = 8;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxWaitUs, "100000"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  InitDynamicBatchingSession(session_object);
+
+  // half the requests use a different run tag so they have to be batched separately
+  std::vector<std::vector<OrtValue>> fetches(num_requests);
+  std::vector<Status> statuses(num_requests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([&session_object, &fetches, &statuses, i]() {
+      RunOptions run_options;
+      run_options.run_tag = (i % 2 == 0) ? "even" : "odd";
+      statuses[i] = RunDynamicBatchingRequest(session_object, run_options, i, fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    VerifyOutputs(fetches[i], {1, 2}, {3.f * i, 2.f * i});
+  }
+}
+
+TEST(InferenceSessionTests, DynamicBatchingTerminateFollower) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.DynamicBatchingTerminateFollower";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "4"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxWaitUs, "500000"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  InitDynamicBatchingSession(session_object);
+
+  // the follower is terminated while its batch is still waiting for more requests. whether or not it joined the
+  // leader's batch by then, only the follower must fail.
+  RunOptions leader_run_options;
+  RunOptions follower_run_options;
+  std::vector<OrtValue> leader_fetches;
+  std::vector<OrtValue> follower_fetches;
+  Status leader_status;
+  Status follower_status;
+  std::thread leader([&]() {
+    leader_status = RunDynamicBatchingRequest(session_object, leader_run_options, 1, leader_fetches);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::thread follower([&]() {
+    follower_status = RunDynamicBatchingRequest(session_object, follower_run_options, 2, follower_fetches);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  follower_run_options.terminate = true;
+
+  leader.join();
+  follower.join();
+
+  ASSERT_STATUS_OK(leader_status);
+  VerifyOutputs(leader_fetches, {1, 2}, {3.f, 2.f});
+  ASSERT_FALSE(follower_status.IsOK());
+  EXPECT_THAT(follower_status.ErrorMessage(), testing::HasSubstr("terminate flag"));
+}
+
+TEST(InferenceSessionTests, ArenaReserveInputShapes) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ArenaReserveInputShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigArenaReserveInputShapes,
+                                                    "A:4,2;B:4,2|A:64,2;B:64,2"));
+
+  // Y = (A * B) * B with a symbolic dim 0, so the size of the intermediate value depends on the input shapes
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = tensor_float.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("N");
+  shape->add_dim()->set_dim_value(2);
+  auto& input_arg_a = graph.GetOrCreateNodeArg("A", &tensor_float);
+  auto& input_arg_b = graph.GetOrCreateNodeArg("B", &tensor_float);
+  auto& intermediate_arg = graph.GetOrCreateNodeArg("T", nullptr);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("node1", "Mul", "Mul", {&input_arg_a, &input_arg_b}, {&intermediate_arg});
+  graph.AddNode("node2", "Mul", "Mul", {&intermediate_arg, &input_arg_b}, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto cpu_alloc = session_object.GetAllocator(OrtMemoryInfo(CPU, OrtArenaAllocator));
+  ASSERT_NE(cpu_alloc, nullptr);
+  if (cpu_alloc->Info().alloc_type == OrtArenaAllocator) {
+    // a single region sized for the intermediate value of the largest shape set
+    AllocatorStats alloc_stats;
+    static_cast<BFCArena*>(cpu_alloc.get())->GetStats(&alloc_stats);
+    ASSERT_EQ(alloc_stats.num_arena_extensions, 1);
+    ASSERT_EQ(alloc_stats.total_allocated_bytes, static_cast<int64_t>(64 * 2 * sizeof(float)));
+  }
+
+  std::vector<float> a_values(128, 1.f);
+  std::vector<float> b_values(128, 2.f);
+  OrtValue a, b;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {64, 2}, a_values, &a);
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {64, 2}, b_values, &b);
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, {"A", "B"}, {a, b}, {"Y"}, &fetches));
+  VerifyOutputs(fetches, {64, 2}, std::vector<float>(128, 4.f));
+}
+
+TEST(InferenceSessionTests, InvalidArenaReserveInputShapes) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.InvalidArenaReserveInputShapes";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigArenaReserveInputShapes, "X:3,two"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  auto status = session_object.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Invalid dim"));
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -6,6 +6,8 @@
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
 
 #include "gtest/gtest.h"
 
@@ -145,5 +147,71 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+// wide graph with many independent branches that each contain a chain of small nodes, so that nodes are
+// run inline, queued and stolen by the workers
+TEST(ParallelExecutor, TestWideGraph) {
+  constexpr int num_branches = 16;
+  constexpr int branch_depth = 4;
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 12;
+  Model model("WideGraph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+
+  std::vector<NodeArg*> branch_outputs;
+  for (int b = 0; b < num_branches; ++b) {
+    NodeArg* input = &x;
+    for (int d = 0; d < branch_depth; ++d) {
+      const std::string name = "branch_" + std::to_string(b) + "_" + std::to_string(d);
+      auto& output = graph.GetOrCreateNodeArg(name, &tensor_float);
+      graph.AddNode(name, "Add", "", {input, &x}, {&output});
+      input = &output;
+    }
+
+    branch_outputs.push_back(input);
+  }
+
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  graph.AddNode("sum", "Sum", "", branch_outputs, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.TestWideGraph";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::vector<float> x_values = {1.f, 2.f, 3.f, 4.f};
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 2}, x_values, &x_value);
+
+  // each branch computes (branch_depth + 1) * X
+  std::vector<float> expected;
+  for (float v : x_values) {
+    expected.push_back(v * (branch_depth + 1) * num_branches);
+  }
+
+  // run multiple times so different interleavings of the workers are exercised
+  for (int i = 0; i < 10; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, {"X"}, {x_value}, {"Y"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(std::vector<float>(result.begin(), result.end()), expected);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,7 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 #include "asserts.h"
 #include "core/framework/execution_providers.h"
@@ -328,11 +332,36 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                      std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      /*out*/ bool& used_persisted_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    weight_packed_ = std::move(prepacked_buffers[0]);
+    used_persisted_buffers = true;
+    ++use_persisted_pre_packed_weight_calls_count;
+    return Status::OK();
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int use_persisted_pre_packed_weight_calls_count = 0;
   BufferUniquePtr weight_packed_;
 };
 
+// Like most kernels, can't use pre-packed buffers persisted to a file
+class PrePackingNotPersistedTestOpKernel : public PrePackingTestOpKernel {
+ public:
+  PrePackingNotPersistedTestOpKernel(const OpKernelInfo& info) : PrePackingTestOpKernel(info) {}
+
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                      std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      /*out*/ bool& used_persisted_buffers) override {
+    return OpKernel::UsePersistedPrePackedBuffers(tensor, input_idx, prepacked_buffers, used_persisted_buffers);
+  }
+};
+
 static void CreateSimpleGraph(Graph& graph) {
   // node creation and placement
   TypeProto type;
@@ -776,6 +805,113 @@ TEST(SessionStateTest, SharedInitalizersWithPrePackingTest) {
   }
 }
 
+static std::string ReadFileContents(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void RunPrePackingWithFileCacheTest(bool kernel_uses_persisted_buffers) {
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ONNX_OPERATOR_SCHEMA(PrePackingTest)
+      .SetDoc("Faking Node for PrePacking")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider)));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 11;
+
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def = KernelDefBuilder().SetName("PrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [kernel_uses_persisted_buffers](FuncManager&, const OpKernelInfo& info,
+                                                       std::unique_ptr<OpKernel>& out) -> Status {
+                         if (kernel_uses_persisted_buffers) {
+                           out = std::make_unique<PrePackingTestOpKernel>(info);
+                         } else {
+                           out = std::make_unique<PrePackingNotPersistedTestOpKernel>(info);
+                         }
+                         return Status::OK();
+                       })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  const std::string cache_file = "prepacking_with_file_cache_test.prepacked";
+  std::remove(cache_file.c_str());
+
+  SessionOptions sess_options;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigPrepackedWeightsCacheFile] = cache_file;
+
+  // the first session packs the weight and writes it to the file, the later ones use it from the file and must
+  // leave the file alone. a kernel that can't use persisted buffers packs the weight every time and gets no file.
+  std::string first_contents;
+  std::filesystem::file_time_type first_write_time;
+  for (int i = 0; i < 3; ++i) {
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               true, /*enable_mem_pattern*/
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager,
+                                                        sess_options));
+
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(0));
+    const bool from_file = kernel_uses_persisted_buffers && i > 0;
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(kernel->prepack_calls_count, from_file ? 0 : 1);
+    // the freshly packed buffers are offered to the kernel too, to find out if they can be written to the file
+    ASSERT_EQ(kernel->use_persisted_pre_packed_weight_calls_count, kernel_uses_persisted_buffers ? 1 : 0);
+    ASSERT_EQ(session_state.GetUsedPersistedPrePackedWeightCounter(), static_cast<size_t>(from_file ? 1 : 0));
+
+    const float* weight = static_cast<const float*>(kernel->weight_packed_.get());
+    ASSERT_EQ(weight[0], 1.2345f);
+    ASSERT_EQ(weight[1], 1.2345f * 2.f);
+
+    if (!kernel_uses_persisted_buffers) {
+      ASSERT_FALSE(std::filesystem::exists(cache_file));
+    } else if (i == 0) {
+      first_contents = ReadFileContents(cache_file);
+      first_write_time = std::filesystem::last_write_time(cache_file);
+      ASSERT_FALSE(first_contents.empty());
+    } else {
+      ASSERT_EQ(ReadFileContents(cache_file), first_contents);
+      ASSERT_EQ(std::filesystem::last_write_time(cache_file), first_write_time);
+    }
+  }
+
+  std::remove(cache_file.c_str());
+}
+
+TEST(SessionStateTest, PrePackingWithFileCacheTest) {
+  RunPrePackingWithFileCacheTest(true);
+}
+
+TEST(SessionStateTest, PrePackingWithFileCacheNotPersistedTest) {
+  RunPrePackingWithFileCacheTest(false);
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> layernorm_bench_arg_names = {"Rows", "N"};
+
+void LAYERNORM(benchmark::State& state, bool skip, bool simplified) {
+  if (state.range(0) <= 0) throw std::invalid_argument("Rows must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t rows = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  auto input = RandomVectorUniform(rows * N, -1.0f, 1.0f);
+  auto skip_input = RandomVectorUniform(rows * N, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(N, -1.0f, 1.0f);
+  auto scale = RandomVectorUniform(N, -1.0f, 1.0f);
+  auto shift = RandomVectorUniform(N, -1.0f, 1.0f);
+  std::vector<float> output(rows * N);
+
+  for (auto _ : state) {
+    for (size_t r = 0; r < rows; r++) {
+      MlasComputeLayerNorm(input.data() + r * N,
+                           skip ? skip_input.data() + r * N : nullptr,
+                           skip ? bias.data() : nullptr,
+                           nullptr,
+                           scale.data(),
+                           simplified ? nullptr : shift.data(),
+                           output.data() + r * N,
+                           N,
+                           1e-5f,
+                           simplified,
+                           nullptr,
+                           nullptr);
+    }
+  }
+}
+
+static void LayerNormSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(layernorm_bench_arg_names);
+  ArgsProduct(b, {{1, 128, 512}, {127, 768, 1024, 4096}});
+}
+
+BENCHMARK_CAPTURE(LAYERNORM, LayerNorm, false, false)->Apply(LayerNormSizes)->UseRealTime();
+BENCHMARK_CAPTURE(LAYERNORM, SimplifiedLayerNorm, false, true)->Apply(LayerNormSizes)->UseRealTime();
+BENCHMARK_CAPTURE(LAYERNORM, SkipLayerNorm, true, false)->Apply(LayerNormSizes)->UseRealTime();
@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasHalfConvertBufferTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint16_t> BufferHalf;
+  MatrixGuardBuffer<uint16_t> BufferHalfReference;
+  MatrixGuardBuffer<float> BufferFloat;
+  MatrixGuardBuffer<float> BufferFloatReference;
+
+  static float BitsToFloat(uint32_t Bits) {
+    float Value;
+    memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+  }
+
+  static uint32_t FloatToBits(float Value) {
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    return Bits;
+  }
+
+  static bool IsNaN(MLAS_HALF_TYPE Type, uint16_t Value) {
+    return (Type == MlasHalfTypeBf16) ? (Value & 0x7FFF) > 0x7F80 : (Value & 0x7FFF) > 0x7C00;
+  }
+
+  static float ReferenceHalfToFloat(MLAS_HALF_TYPE Type, uint16_t Value) {
+    if (Type == MlasHalfTypeBf16) {
+      return BitsToFloat(uint32_t(Value) << 16);
+    }
+
+    const int Exponent = (Value >> 10) & 0x1F;
+    const int Mantissa = Value & 0x3FF;
+    double Magnitude;
+
+    if (Exponent == 0x1F) {
+      Magnitude = (Mantissa == 0) ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+    } else if (Exponent == 0) {
+      Magnitude = std::ldexp(double(Mantissa), -24);
+    } else {
+      Magnitude = std::ldexp(double(Mantissa + 1024), Exponent - 25);
+    }
+
+    return float((Value & 0x8000) != 0 ? -Magnitude : Magnitude);
+  }
+
+  static uint16_t ReferenceFloatToHalf(MLAS_HALF_TYPE Type, float Value) {
+    const uint32_t Bits = FloatToBits(Value);
+
+    if (Type == MlasHalfTypeBf16) {
+      uint32_t Result = Bits >> 16;
+      const uint32_t Remainder = Bits & 0xFFFF;
+      if (Remainder > 0x8000 || (Remainder == 0x8000 && (Result & 1) != 0)) {
+        Result++;
+      }
+      return uint16_t(Result);
+    }
+
+    const uint16_t Sign = uint16_t((Bits >> 16) & 0x8000);
+    const double Magnitude = std::fabs(double(Value));
+
+    if (Magnitude >= 65520.0) {
+      return uint16_t(Sign | 0x7C00);
+    }
+
+    if (Magnitude == 0.0) {
+      return Sign;
+    }
+
+    //
+    // Round the magnitude to a multiple of the unit in the last place of the
+    // half precision binade with round to nearest even.
+    //
+
+    int Exponent;
+    std::frexp(Magnitude, &Exponent);
+    Exponent = std::max(Exponent - 1, -14);
+
+    const double Rounded = std::nearbyint(std::ldexp(Magnitude, 10 - Exponent));
+
+    return uint16_t(Sign | (((Exponent + 15) << 10) + int(Rounded) - 1024));
+  }
+
+  void TestHalfToFloat(MLAS_HALF_TYPE Type, const std::vector<uint16_t>& Values, size_t Offset) {
+    const size_t Count = Values.size() - Offset;
+    uint16_t* Source = BufferHalf.GetBuffer(Count);
+    float* Destination = BufferFloat.GetBuffer(Count);
+
+    std::copy(Values.begin() + Offset, Values.end(), Source);
+
+    MlasConvertHalfToFloat(Type, Source, Destination, Count);
+
+    for (size_t i = 0; i < Count; i++) {
+      if (IsNaN(Type, Source[i])) {
+        ASSERT_TRUE(std::isnan(Destination[i])) << "@" << i << " of " << Count << ", source: " << Source[i];
+      } else {
+        const float Reference = ReferenceHalfToFloat(Type, Source[i]);
+        ASSERT_EQ(FloatToBits(Destination[i]), FloatToBits(Reference))
+            << "@" << i << " of " << Count << ", source: " << Source[i] << ", got: " << Destination[i]
+            << ", expecting: " << Reference;
+      }
+    }
+  }
+
+  void TestFloatToHalf(MLAS_HALF_TYPE Type, const std::vector<float>& Values, size_t Offset) {
+    const size_t Count = Values.size() - Offset;
+    float* Source = BufferFloat.GetBuffer(Count);
+    uint16_t* Destination = BufferHalf.GetBuffer(Count);
+
+    std::copy(Values.begin() + Offset, Values.end(), Source);
+
+    MlasConvertFloatToHalf(Type, Source, Destination, Count);
+
+    for (size_t i = 0; i < Count; i++) {
+      if (std::isnan(Source[i])) {
+        ASSERT_TRUE(IsNaN(Type, Destination[i])) << "@" << i << " of " << Count << ", got: " << Destination[i];
+      } else {
+        const uint16_t Reference = ReferenceFloatToHalf(Type, Source[i]);
+        ASSERT_EQ(Destination[i], Reference)
+            << "@" << i << " of " << Count << ", source: " << Source[i] << " (0x" << std::hex
+            << FloatToBits(Source[i]) << "), got: 0x" << Destination[i] << ", expecting: 0x" << Reference;
+      }
+    }
+  }
+
+  void Test(MLAS_HALF_TYPE Type) {
+    //
+    // Every 16-bit value.
+    //
+
+    std::vector<uint16_t> HalfValues(65536);
+    for (size_t i = 0; i < HalfValues.size(); i++) {
+      HalfValues[i] = uint16_t(i);
+    }
+
+    TestHalfToFloat(Type, HalfValues, 0);
+
+    //
+    // Every 16-bit value and the values in between two adjacent ones, which
+    // check the rounding of ties, along with random and special values.
+    //
+
+    std::vector<float> FloatValues;
+    for (uint32_t i = 0; i < 65536; i++) {
+      if (IsNaN(Type, uint16_t(i)) || IsNaN(Type, uint16_t(i + 1)) || (i & 0x7FFF) == 0x7FFF) {
+        continue;
+      }
+      const float Value = ReferenceHalfToFloat(Type, uint16_t(i));
+      const float Next = ReferenceHalfToFloat(Type, uint16_t(i + 1));
+      FloatValues.push_back(Value);
+      if (std::isfinite(Next)) {
+        const float Middle = float((double(Value) + double(Next)) / 2.0);
+        FloatValues.push_back(Middle);
+        FloatValues.push_back(std::nextafter(Middle, -std::numeric_limits<float>::infinity()));
+        FloatValues.push_back(std::nextafter(Middle, std::numeric_limits<float>::infinity()));
+      }
+    }
+
+    std::default_random_engine generator(static_cast<unsigned>(Type));
+    std::uniform_int_distribution<uint32_t> distribution(0, 0xFFFFFFFF);
+    for (size_t i = 0; i < 65536; i++) {
+      FloatValues.push_back(BitsToFloat(distribution(generator)));
+    }
+
+    for (float Value : {0.0f, -0.0f, 65504.0f, 65519.99f, 65520.0f, 1e10f, 3e-8f, 2.98e-8f, 1e-10f}) {
+      FloatValues.push_back(Value);
+      FloatValues.push_back(-Value);
+    }
+    FloatValues.push_back(std::numeric_limits<float>::infinity());
+    FloatValues.push_back(-std::numeric_limits<float>::infinity());
+    FloatValues.push_back(std::numeric_limits<float>::quiet_NaN());
+    FloatValues.push_back(-std::numeric_limits<float>::quiet_NaN());
+
+    TestFloatToHalf(Type, FloatValues, 0);
+
+    //
+    // Short buffers and unaligned remainders.
+    //
+
+    for (size_t Offset = 1; Offset < 48; Offset++) {
+      TestHalfToFloat(Type, std::vector<uint16_t>(HalfValues.end() - 48, HalfValues.end()), Offset);
+      TestFloatToHalf(Type, std::vector<float>(FloatValues.end() - 48, FloatValues.end()), Offset);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("HalfConvertBuffer");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    Test(MlasHalfTypeFp16);
+    Test(MlasHalfTypeBf16);
+  }
+};
+
+template <> MlasHalfConvertBufferTest* MlasTestFixture<MlasHalfConvertBufferTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasHalfConvertBufferTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <vector>
+
+template <MLAS_HALF_TYPE Type, bool Threaded>
+class MlasHalfGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint16_t> BufferA;
+  MatrixGuardBuffer<uint16_t> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<uint16_t> BufferC;
+  MatrixGuardBuffer<float> BufferFloat;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void FillHalf(uint16_t* Buffer, size_t Count, float* Scratch, int seed) {
+    // Multiples of 1/8 in [-2, 2] are exact in both formats, so only the output rounding differs from the reference.
+    std::default_random_engine generator(static_cast<unsigned>(seed));
+    std::uniform_int_distribution<int> distribution(-16, 16);
+    for (size_t i = 0; i < Count; i++) {
+      Scratch[i] = distribution(generator) / 8.0f;
+    }
+    MlasConvertFloatToHalf(Type, Scratch, Buffer, Count);
+  }
+
+  void Test(size_t M, size_t N, size_t K, bool TransA, bool TransB, float alpha, float beta) {
+    uint16_t* A = BufferA.GetBuffer(M * K);
+    uint16_t* B = BufferB.GetBuffer(K * N);
+    uint16_t* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+    float* Scratch = BufferFloat.GetBuffer(std::max(M * K, std::max(K * N, M * N)));
+
+    FillHalf(A, M * K, Scratch, int(M * K));
+    FillHalf(B, K * N, Scratch, int(K * N + 1));
+    FillHalf(C, M * N, Scratch, int(M * N + 2));
+
+    std::vector<float> a(M * K), b(K * N);
+    MlasConvertHalfToFloat(Type, A, a.data(), M * K);
+    MlasConvertHalfToFloat(Type, B, b.data(), K * N);
+    MlasConvertHalfToFloat(Type, C, CReference, M * N);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          const float av = TransA ? a[k * M + m] : a[m * K + k];
+          const float bv = TransB ? b[n * K + k] : b[k * N + n];
+          sum += av * bv;
+        }
+        CReference[m * N + n] = alpha * sum + (beta != 0.0f ? beta * CReference[m * N + n] : 0.0f);
+      }
+    }
+
+    void* PackedB = BufferBPacked.GetBuffer(MlasHalfGemmPackBSize(N, K), true);
+    MlasHalfGemmPackB(TransB ? CblasTrans : CblasNoTrans, N, K, B, TransB ? K : N, PackedB);
+
+    MLAS_HALF_GEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = TransA ? M : K;
+    Data.PackedB = PackedB;
+    Data.C = C;
+    Data.ldc = N;
+    Data.alpha = alpha;
+    Data.beta = beta;
+    MlasHalfGemmBatch(Type, TransA ? CblasTrans : CblasNoTrans, M, N, K, &Data, 1, threadpool_);
+
+    std::vector<float> c(M * N);
+    MlasConvertHalfToFloat(Type, C, c.data(), M * N);
+
+    // The result is rounded once to the 16-bit format.
+    const float RelativeTolerance = (Type == MlasHalfTypeBf16) ? 1.0f / 128.0f : 1.0f / 1024.0f;
+
+    for (size_t i = 0; i < M * N; i++) {
+      const float diff = std::fabs(c[i] - CReference[i]);
+      ASSERT_TRUE(diff <= std::fabs(CReference[i]) * RelativeTolerance + 1e-6f)
+          << " @" << i << " of [" << M << "," << N << "," << K << "] TransA=" << TransA << " TransB=" << TransB
+          << " alpha=" << alpha << " beta=" << beta << ", got: " << c[i] << ", expecting: " << CReference[i];
+    }
+  }
+
+ public:
+  MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string(Type == MlasHalfTypeBf16 ? "HalfGemmBf16" : "HalfGemmFp16") +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t b = 1; b < 16; b++) {
+      Test(b, b, b, false, false, 1.0f, 0.0f);
+      Test(b, b, b, true, true, 1.0f, 0.0f);
+    }
+    for (size_t b = 1; b < 16; b++) {
+      Test(b, b, b, false, true, 0.5f, 1.0f);
+      Test(b, b, b, true, false, 1.0f, -0.5f);
+    }
+    Test(1, 200, 300, false, false, 1.0f, 0.0f);
+    Test(70, 130, 260, false, true, 1.0f, 0.0f);
+    Test(150, 64, 129, true, false, 2.0f, 0.5f);
+    Test(33, 257, 0, false, false, 1.0f, 0.5f);
+  }
+};
+
+template <>
+MlasHalfGemmTest<MlasHalfTypeFp16, false>* MlasTestFixture<MlasHalfGemmTest<MlasHalfTypeFp16, false>>::mlas_tester(nullptr);
+template <>
+MlasHalfGemmTest<MlasHalfTypeFp16, true>* MlasTestFixture<MlasHalfGemmTest<MlasHalfTypeFp16, true>>::mlas_tester(nullptr);
+template <>
+MlasHalfGemmTest<MlasHalfTypeBf16, false>* MlasTestFixture<MlasHalfGemmTest<MlasHalfTypeBf16, false>>::mlas_tester(nullptr);
+template <>
+MlasHalfGemmTest<MlasHalfTypeBf16, true>* MlasTestFixture<MlasHalfGemmTest<MlasHalfTypeBf16, true>>::mlas_tester(nullptr);
+
+class MlasHalfConvertTest : public MlasTestBase {
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("HalfConvert");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    // Every finite 16-bit value converts to single precision and back unchanged.
+    for (MLAS_HALF_TYPE type : {MlasHalfTypeFp16, MlasHalfTypeBf16}) {
+      const uint16_t exponent_mask = (type == MlasHalfTypeBf16) ? 0x7F80 : 0x7C00;
+      for (uint32_t i = 0; i <= 0xFFFF; i++) {
+        const uint16_t value = static_cast<uint16_t>(i);
+        if ((value & exponent_mask) == exponent_mask) {
+          continue;
+        }
+        float f;
+        uint16_t round_trip;
+        MlasConvertHalfToFloat(type, &value, &f, 1);
+        MlasConvertFloatToHalf(type, &f, &round_trip, 1);
+        ASSERT_EQ(round_trip, value) << " type=" << type << " value=" << value;
+      }
+    }
+
+    // Rounding to nearest even, overflow and denormals.
+    const float inputs[] = {1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 70000.0f, 1e-7f, -2.5f};
+    const uint16_t expected[] = {0x3C00, 0x3C02, 0x7C00, 0x0002, 0xC100};
+    uint16_t outputs[5];
+    MlasConvertFloatToHalf(MlasHalfTypeFp16, inputs, outputs, 5);
+    for (size_t i = 0; i < 5; i++) {
+      ASSERT_EQ(outputs[i], expected[i]) << " input=" << inputs[i];
+    }
+  }
+};
+
+template <> MlasHalfConvertTest* MlasTestFixture<MlasHalfConvertTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasHalfConvertTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<MlasHalfTypeFp16, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<MlasHalfTypeFp16, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<MlasHalfTypeBf16, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasHalfGemmTest<MlasHalfTypeBf16, true>>::RegisterShortExecute();
+  }
+  return count;
+});
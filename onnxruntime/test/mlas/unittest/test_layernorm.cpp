@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferShift;
+  MatrixGuardBuffer<float> BufferSum;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+
+  void Test(size_t N, float Offset, bool WithSkip, bool WithBias, bool WithShift, bool WithSum, bool Simplified) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Skip = WithSkip ? BufferSkip.GetBuffer(N) : nullptr;
+    float* Bias = WithBias ? BufferBias.GetBuffer(N) : nullptr;
+    float* Scale = BufferScale.GetBuffer(N);
+    float* Shift = WithShift ? BufferShift.GetBuffer(N) : nullptr;
+    float* Sum = WithSum ? BufferSum.GetBuffer(N) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N);
+    float* OutputReference = BufferOutputReference.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = Offset + distribution(generator);
+      if (Skip != nullptr) {
+        Skip[n] = distribution(generator);
+      }
+      if (Bias != nullptr) {
+        Bias[n] = distribution(generator);
+      }
+      Scale[n] = distribution(generator);
+      if (Shift != nullptr) {
+        Shift[n] = distribution(generator);
+      }
+    }
+
+    constexpr float Epsilon = 1e-5f;
+
+    float Mean;
+    float InvStdDev;
+    MlasComputeLayerNorm(Input, Skip, Bias, Sum, Scale, Shift, Output, N, Epsilon, Simplified, &Mean, &InvStdDev);
+
+    //
+    // Compute the reference with the two pass formula in double precision.
+    //
+
+    std::vector<double> X(N);
+    double MeanReference = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      X[n] = double(Input[n]) + (Skip != nullptr ? double(Skip[n]) : 0.0) + (Bias != nullptr ? double(Bias[n]) : 0.0);
+      MeanReference += X[n];
+    }
+    MeanReference = Simplified ? 0.0 : MeanReference / N;
+
+    double Variance = 0.0;
+    for (size_t n = 0; n < N; n++) {
+      Variance += (X[n] - MeanReference) * (X[n] - MeanReference);
+    }
+    const double InvStdDevReference = 1.0 / std::sqrt(Variance / N + Epsilon);
+
+    for (size_t n = 0; n < N; n++) {
+      OutputReference[n] = float((X[n] - MeanReference) * InvStdDevReference * Scale[n] +
+                                 (Shift != nullptr ? double(Shift[n]) : 0.0));
+    }
+
+    constexpr float AbsoluteTolerance = 1e-4f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    auto CloseEnough = [&](float Value, double Reference) {
+      double diff = std::fabs(double(Value) - Reference);
+      return diff <= AbsoluteTolerance || diff <= std::fabs(Reference) * RelativeTolerance;
+    };
+
+    ASSERT_TRUE(CloseEnough(Mean, MeanReference)) << "Mean N=" << N << ", got: " << Mean << ", expecting: " << MeanReference;
+    ASSERT_TRUE(CloseEnough(InvStdDev, InvStdDevReference))
+        << "InvStdDev N=" << N << ", got: " << InvStdDev << ", expecting: " << InvStdDevReference;
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_TRUE(CloseEnough(Output[n], OutputReference[n]))
+          << "Output @" << n << " of " << N << " Skip:" << WithSkip << " Bias:" << WithBias << " Shift:" << WithShift
+          << " Simplified:" << Simplified << ", got: " << Output[n] << ", expecting: " << OutputReference[n];
+      if (Sum != nullptr) {
+        float SumReference = Input[n];
+        if (Skip != nullptr) {
+          SumReference += Skip[n];
+        }
+        if (Bias != nullptr) {
+          SumReference += Bias[n];
+        }
+        ASSERT_EQ(Sum[n], SumReference) << "Sum @" << n << " of " << N;
+      }
+    }
+
+    //
+    // The output may alias the input.
+    //
+
+    if (Skip == nullptr && Bias == nullptr) {
+      MlasComputeLayerNorm(Input, nullptr, nullptr, nullptr, Scale, Shift, Input, N, Epsilon, Simplified, nullptr, nullptr);
+      for (size_t n = 0; n < N; n++) {
+        ASSERT_EQ(Input[n], Output[n]) << "In place @" << n << " of " << N;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LayerNorm");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n = 1; n < 80; n++) {
+      Test(n, 0.0f, false, false, true, false, false);
+      Test(n, 0.0f, true, true, true, true, false);
+      Test(n, 0.0f, true, false, false, false, true);
+    }
+
+    for (size_t n : {256, 768, 1023, 1024, 4096}) {
+      Test(n, 0.0f, false, false, false, false, false);
+      Test(n, 0.0f, false, false, true, false, true);
+      Test(n, 0.0f, true, false, true, false, false);
+      Test(n, 0.0f, true, true, true, true, false);
+    }
+
+    // A large mean relative to the spread of the values.
+    Test(768, 1000.0f, false, false, true, false, false);
+    Test(1023, 1000.0f, true, true, true, true, false);
+  }
+};
+
+template <> MlasLayerNormTest* MlasTestFixture<MlasLayerNormTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <vector>
+
+template <size_t BlkBitWidth, bool Threaded>
+class MlasQNBitGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void Fill(float* Buffer, size_t Count, int seed) {
+    std::default_random_engine generator(static_cast<unsigned>(seed));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < Count; i++) {
+      Buffer[i] = distribution(generator);
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, size_t BlkLen, bool Symmetric, bool WithBias) {
+    float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(K * N);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    Fill(A, M * K, int(M * K));
+    Fill(B, K * N, int(K * N + 1));
+    Fill(Bias, N, int(N + 2));
+
+    size_t QuantBDataSize;
+    size_t QuantBScaleCount;
+    size_t QuantBZeroPointSize;
+    MlasQNBitGemmQuantBSizes(N, K, BlkBitWidth, BlkLen, &QuantBDataSize, &QuantBScaleCount, &QuantBZeroPointSize);
+
+    std::vector<uint8_t> QuantBData(QuantBDataSize);
+    std::vector<float> QuantBScale(QuantBScaleCount);
+    std::vector<uint8_t> QuantBZeroPoint(QuantBZeroPointSize);
+
+    MlasQNBitGemmQuantizeB(N, K, BlkBitWidth, BlkLen, B, N, QuantBData.data(), QuantBScale.data(),
+                           Symmetric ? nullptr : QuantBZeroPoint.data(), threadpool_);
+
+    // Dequantize matrix B from the documented format and check the quantization error. Values at the far end of
+    // the range may be clamped, so the error is bounded by one quantization step.
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t BlkDataSize = BlkLen * BlkBitWidth / 8;
+    const size_t ZeroPointStride = (BlockCountK * BlkBitWidth + 7) / 8;
+
+    auto GetValue = [](const uint8_t* Buffer, size_t Index) -> int {
+      return BlkBitWidth == 4 ? (Buffer[Index / 2] >> ((Index % 2) * 4)) & 0x0F : Buffer[Index];
+    };
+
+    std::vector<float> DequantB(K * N);
+    for (size_t n = 0; n < N; n++) {
+      for (size_t k = 0; k < K; k++) {
+        const size_t blk = k / BlkLen;
+        const float scale = QuantBScale[n * BlockCountK + blk];
+        const int zp = Symmetric ? (1 << (BlkBitWidth - 1)) : GetValue(QuantBZeroPoint.data() + n * ZeroPointStride, blk);
+        const int q = GetValue(QuantBData.data() + (n * BlockCountK + blk) * BlkDataSize, k % BlkLen);
+        DequantB[k * N + n] = (q - zp) * scale;
+        ASSERT_LE(std::fabs(DequantB[k * N + n] - B[k * N + n]), std::fabs(scale) * 1.0001f)
+            << " quantization error @[" << k << "," << n << "] BlkLen=" << BlkLen;
+      }
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float sum = WithBias ? Bias[n] : 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          sum += A[m * K + k] * DequantB[k * N + n];
+        }
+        CReference[m * N + n] = sum;
+      }
+    }
+
+    MLAS_QNBIT_GEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.QuantBData = QuantBData.data();
+    Data.QuantBScale = QuantBScale.data();
+    Data.QuantBZeroPoint = Symmetric ? nullptr : QuantBZeroPoint.data();
+    Data.Bias = WithBias ? Bias : nullptr;
+    Data.C = C;
+    Data.ldc = N;
+    MlasQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, &Data, threadpool_);
+
+    for (size_t i = 0; i < M * N; i++) {
+      const float diff = std::fabs(C[i] - CReference[i]);
+      ASSERT_TRUE(diff <= std::fabs(CReference[i]) * 1e-5f + 1e-4f)
+          << " @" << i << " of [" << M << "," << N << "," << K << "] BlkLen=" << BlkLen
+          << " Symmetric=" << Symmetric << " Bias=" << WithBias << ", got: " << C[i] << ", expecting: " << CReference[i];
+    }
+  }
+
+ public:
+  MlasQNBitGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("QNBitGemm") + std::to_string(BlkBitWidth) +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t BlkLen : {16, 32, 64, 128, 256}) {
+      ASSERT_TRUE(MlasIsQNBitGemmAvailable(BlkBitWidth, BlkLen));
+      for (bool Symmetric : {false, true}) {
+        Test(1, 1, 1, BlkLen, Symmetric, false);
+        Test(1, 17, 15, BlkLen, Symmetric, true);
+        Test(1, 64, 300, BlkLen, Symmetric, false);
+        Test(3, 33, 257, BlkLen, Symmetric, true);
+        Test(5, 40, 129, BlkLen, Symmetric, false);
+        Test(33, 100, 512, BlkLen, Symmetric, true);
+      }
+    }
+    Test(4, 20, 0, 32, false, true);
+    ASSERT_FALSE(MlasIsQNBitGemmAvailable(BlkBitWidth, 24));
+    ASSERT_FALSE(MlasIsQNBitGemmAvailable(3, 32));
+  }
+};
+
+template <>
+MlasQNBitGemmTest<4, false>* MlasTestFixture<MlasQNBitGemmTest<4, false>>::mlas_tester(nullptr);
+template <>
+MlasQNBitGemmTest<4, true>* MlasTestFixture<MlasQNBitGemmTest<4, true>>::mlas_tester(nullptr);
+template <>
+MlasQNBitGemmTest<8, false>* MlasTestFixture<MlasQNBitGemmTest<8, false>>::mlas_tester(nullptr);
+template <>
+MlasQNBitGemmTest<8, true>* MlasTestFixture<MlasQNBitGemmTest<8, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasQNBitGemmTest<4, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQNBitGemmTest<4, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQNBitGemmTest<8, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQNBitGemmTest<8, true>>::RegisterShortExecute();
+  }
+  return count;
+});
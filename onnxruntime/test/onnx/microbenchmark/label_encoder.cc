@@ -0,0 +1,108 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <unordered_map>
+
+#include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/ml/lookup_table.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+using namespace onnxruntime::ml;
+
+namespace {
+
+// n_keys random category names and n_inputs lookups of which about one in ten misses.
+struct StringLookupData {
+  StringLookupData(int64_t n_keys, int64_t n_inputs) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> length_dist(4, 24);
+    std::uniform_int_distribution<int> char_dist('a', 'z');
+    for (int64_t i = 0; i < n_keys; ++i) {
+      std::string key(static_cast<size_t>(length_dist(gen)), ' ');
+      for (auto& c : key) {
+        c = static_cast<char>(char_dist(gen));
+      }
+      keys.push_back(key + std::to_string(i));
+      values.push_back(i);
+    }
+
+    std::uniform_int_distribution<int64_t> key_dist(0, n_keys * 10 / 9);
+    for (int64_t i = 0; i < n_inputs; ++i) {
+      const int64_t key = key_dist(gen);
+      inputs.push_back(key < n_keys ? keys[static_cast<size_t>(key)] : "missing" + std::to_string(key));
+    }
+    outputs.resize(inputs.size());
+  }
+
+  std::vector<std::string> keys;
+  std::vector<int64_t> values;
+  std::vector<std::string> inputs;
+  std::vector<int64_t> outputs;
+};
+
+}  // namespace
+
+static void BM_StringLookupUnorderedMap(benchmark::State& state) {
+  StringLookupData data(state.range(0), state.range(1));
+  std::unordered_map<std::string, int64_t> map;
+  for (size_t i = 0; i < data.keys.size(); ++i) {
+    map[data.keys[i]] = data.values[i];
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < data.inputs.size(); ++i) {
+      auto found = map.find(data.inputs[i]);
+      data.outputs[i] = found == map.end() ? -1 : found->second;
+    }
+    benchmark::DoNotOptimize(data.outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void RunStringLookupTable(benchmark::State& state, concurrency::ThreadPool* tp) {
+  StringLookupData data(state.range(0), state.range(1));
+  LookupTable<std::string, int64_t> table(data.keys, data.values);
+
+  for (auto _ : state) {
+    LookupBatch<std::string, int64_t>(tp, table, data.inputs, data.outputs, -1);
+    benchmark::DoNotOptimize(data.outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_StringLookupTable(benchmark::State& state) {
+  RunStringLookupTable(state, nullptr);
+}
+
+static void BM_StringLookupTableThreaded(benchmark::State& state) {
+  OrtThreadPoolParams tpo;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<concurrency::ThreadPool> tp(
+      concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP));
+  RunStringLookupTable(state, tp.get());
+}
+
+static void StringLookupArgs(benchmark::internal::Benchmark* b) {
+  // keys, inputs
+  b->Args({100, 1000});
+  b->Args({100, 100000});
+  b->Args({10000, 100000});
+  b->Args({1000000, 100000});
+}
+
+BENCHMARK(BM_StringLookupUnorderedMap)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(StringLookupArgs);
+
+BENCHMARK(BM_StringLookupTable)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(StringLookupArgs);
+
+BENCHMARK(BM_StringLookupTableThreaded)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(StringLookupArgs);
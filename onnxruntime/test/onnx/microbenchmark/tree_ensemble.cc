@@ -0,0 +1,152 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+
+using namespace onnxruntime;
+using namespace onnxruntime::ml::detail;
+
+namespace {
+
+// Exposes ComputeAgg so that every evaluation engine can be run without a kernel context.
+class TreeEnsembleBenchmark : public TreeEnsembleCommon<float, float, float> {
+ public:
+  // Builds n_trees complete binary trees of the given depth on n_features features with random thresholds.
+  TreeEnsembleBenchmark(int64_t n_trees, int64_t depth, int64_t n_features) {
+    std::vector<int64_t> falsenodeids, featureids, nodeids, treeids, truenodeids;
+    std::vector<int64_t> target_ids, target_nodeids, target_treeids;
+    std::vector<float> values, target_weights;
+    std::vector<std::string> modes;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int64_t> feature_dist(0, n_features - 1);
+    std::uniform_real_distribution<float> value_dist(-1, 1);
+
+    const int64_t n_branches = (int64_t(1) << depth) - 1;
+    const int64_t n_nodes = (int64_t(1) << (depth + 1)) - 1;
+    for (int64_t tree = 0; tree < n_trees; ++tree) {
+      for (int64_t node = 0; node < n_nodes; ++node) {
+        treeids.push_back(tree);
+        nodeids.push_back(node);
+        if (node < n_branches) {
+          modes.push_back("BRANCH_LEQ");
+          featureids.push_back(feature_dist(gen));
+          values.push_back(value_dist(gen));
+          truenodeids.push_back(2 * node + 1);
+          falsenodeids.push_back(2 * node + 2);
+        } else {
+          modes.push_back("LEAF");
+          featureids.push_back(0);
+          values.push_back(0);
+          truenodeids.push_back(0);
+          falsenodeids.push_back(0);
+          target_ids.push_back(0);
+          target_nodeids.push_back(node);
+          target_treeids.push_back(tree);
+          target_weights.push_back(value_dist(gen));
+        }
+      }
+    }
+
+    ORT_THROW_IF_ERROR(Init(80, 50, "SUM", {}, {}, 1, falsenodeids, featureids, {}, {}, {}, modes, nodeids, treeids,
+                            truenodeids, values, {}, "NONE", target_ids, target_nodeids, target_treeids,
+                            target_weights, {}));
+  }
+
+  bool UsesFlatLayout() const { return use_flat_layout_; }
+  void DisableFlatLayout() { use_flat_layout_ = false; }
+  bool UsesQuickScorer() const { return use_quick_scorer_; }
+  void DisableQuickScorer() { use_quick_scorer_ = false; }
+
+  void Run(const Tensor* X, Tensor* Y) const {
+    ComputeAgg(nullptr, X, Y, nullptr,
+               TreeAggregatorSum<float, float, float>(roots_.size(), n_targets_or_classes_,
+                                                      post_transform_, base_values_));
+  }
+};
+
+enum class TreeEnsembleEngine {
+  NodeLayout,
+  FlatLayout,
+  QuickScorer,
+};
+
+void RunTreeEnsemble(benchmark::State& state, TreeEnsembleEngine engine) {
+  const int64_t n_trees = state.range(0);
+  const int64_t depth = state.range(1);
+  const int64_t n_rows = state.range(2);
+  const int64_t n_features = 100;
+
+  TreeEnsembleBenchmark trees(n_trees, depth, n_features);
+  if (engine == TreeEnsembleEngine::QuickScorer) {
+    if (!trees.UsesQuickScorer()) {
+      state.SkipWithError("quick scorer is not used");
+      return;
+    }
+  } else {
+    trees.DisableQuickScorer();
+    if (engine == TreeEnsembleEngine::NodeLayout) {
+      trees.DisableFlatLayout();
+    } else if (!trees.UsesFlatLayout()) {
+      state.SkipWithError("flattened layout is not used");
+      return;
+    }
+  }
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  Tensor X(DataTypeImpl::GetType<float>(), TensorShape({n_rows, n_features}), allocator);
+  Tensor Y(DataTypeImpl::GetType<float>(), TensorShape({n_rows, 1}), allocator);
+  float* data = GenerateArrayWithRandomValue<float>(static_cast<size_t>(n_rows * n_features), -1, 1);
+  memcpy(X.MutableData<float>(), data, static_cast<size_t>(n_rows * n_features) * sizeof(float));
+  aligned_free(data);
+
+  for (auto _ : state) {
+    trees.Run(&X, &Y);
+  }
+  state.SetItemsProcessed(state.iterations() * n_rows);
+}
+
+}  // namespace
+
+static void BM_TreeEnsembleNodeLayout(benchmark::State& state) {
+  RunTreeEnsemble(state, TreeEnsembleEngine::NodeLayout);
+}
+
+static void BM_TreeEnsembleFlatLayout(benchmark::State& state) {
+  RunTreeEnsemble(state, TreeEnsembleEngine::FlatLayout);
+}
+
+static void BM_TreeEnsembleQuickScorer(benchmark::State& state) {
+  RunTreeEnsemble(state, TreeEnsembleEngine::QuickScorer);
+}
+
+static void TreeEnsembleArgs(benchmark::internal::Benchmark* b) {
+  // trees, depth, rows
+  b->Args({100, 8, 1});
+  b->Args({100, 8, 1000});
+  b->Args({2000, 8, 1});
+  b->Args({2000, 8, 1000});
+  b->Args({2000, 4, 1000});
+  b->Args({2000, 6, 1000});
+}
+
+BENCHMARK(BM_TreeEnsembleNodeLayout)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(TreeEnsembleArgs);
+
+BENCHMARK(BM_TreeEnsembleFlatLayout)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(TreeEnsembleArgs);
+
+// quick scorer only handles trees with at most 64 leaves
+BENCHMARK(BM_TreeEnsembleQuickScorer)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({100, 6, 1})
+    ->Args({100, 6, 1000})
+    ->Args({2000, 4, 1000})
+    ->Args({2000, 6, 1000});
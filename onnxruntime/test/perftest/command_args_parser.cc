@@ -33,6 +33,9 @@ namespace perftest {
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-Q [target_qps]: Open-loop load test. Requests arrive as a Poisson process at the given rate per second\n"
+      "\t\tand are served by the [parallel runs] clients. Latencies include the time waiting for a free client.\n"
+      "\t\tStops after [seconds_to_run] in 'duration' mode or after [repeated_times] requests in 'times' mode.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|openvino|nuphar|dml|acl|rocm|migraphx]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'openvino', 'nuphar', 'dml', 'acl', 'nnapi', 'coreml', 'rocm' or 'migraphx'. "
       "Default:'cpu'.\n"
@@ -112,9 +115,18 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
   return true;
 }
 
+static bool ParseTargetQps(double& target_qps) {
+  ORT_TRY {
+    target_qps = std::stod(std::basic_string<ORTCHAR_T>(optarg));
+  } ORT_CATCH (...) {
+    return false;
+  }
+  return target_qps > 0;
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:AMPIvhsqz"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:Q:AMPIvhsqz"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -229,6 +241,11 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
           return false;
         }
         break;
+      case 'Q':
+        if (!ParseTargetQps(test_config.run_config.target_qps)) {
+          return false;
+        }
+        break;
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
@@ -7,7 +7,10 @@
 #endif
 
 #include "performance_runner.h"
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -99,12 +102,40 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
       ostream << "P999 Latency: " << sorted_time[n999] << " s" << std::endl;
     };
 
+    // histogram with power of 2 buckets: bucket i > 0 counts the latencies in [2^(i-1), 2^i) us
+    std::vector<size_t> buckets;
+    for (double t : sorted_time) {
+      const double us = t * 1e6;
+      const size_t bucket = us < 1 ? 0 : static_cast<size_t>(std::floor(std::log2(us))) + 1;
+      if (bucket >= buckets.size()) {
+        buckets.resize(bucket + 1);
+      }
+      ++buckets[bucket];
+    }
+    const size_t max_count = *std::max_element(buckets.begin(), buckets.end());
+
+    auto output_histogram = [&](std::ostream& ostream) {
+      ostream << "Latency histogram (us):\n";
+      size_t first = 0;
+      while (buckets[first] == 0) {
+        ++first;
+      }
+      for (size_t i = first; i < buckets.size(); ++i) {
+        const size_t low = i == 0 ? 0 : size_t(1) << (i - 1);
+        ostream << "[" << std::setw(10) << low << ", " << std::setw(10) << (size_t(1) << i) << "): "
+                << std::setw(10) << buckets[i] << " " << std::string(buckets[i] * 50 / max_count, '#') << "\n";
+      }
+      ostream << std::flush;
+    };
+
     if (have_file) {
       outfile << std::endl;
       output_stats(outfile);
+      output_histogram(outfile);
     }
 
     output_stats(std::cout);
+    output_histogram(std::cout);
   }
 }
 
@@ -121,15 +152,19 @@ Status PerformanceRunner::Run() {
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -152,6 +187,14 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.target_qps > 0) {
+    // latencies of the open-loop test are measured from the arrival of the request
+    std::cout << "Target inferences per second: " << performance_test_config_.run_config.target_qps << "\n"
+              << "Concurrent clients: " << performance_test_config_.run_config.concurrent_session_runs << "\n"
+              << "Max queued requests: " << performance_result_.max_queued_requests << "\n"
+              << "Failed inference requests: " << performance_result_.failed_requests << std::endl;
+  }
+
   return Status::OK();
 }
 
@@ -242,6 +285,104 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  using clock = std::chrono::high_resolution_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  // arrival times of the requests waiting for a free client
+  std::deque<clock::time_point> queue;
+  bool done = false;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  std::vector<std::thread> clients;
+  clients.reserve(run_config.concurrent_session_runs);
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    clients.emplace_back([this, &queue, &done, &m, &cv]() { RunOpenLoopClient(queue, done, m, cv); });
+  }
+
+  // requests are queued at their arrival time whether or not a client is free, so a slow request delays the ones
+  // behind it instead of the arrivals.
+  std::mt19937 rng{std::random_device{}()};
+  std::exponential_distribution<double> interarrival_seconds(run_config.target_qps);
+  const auto start = clock::now();
+  const auto end = start + std::chrono::duration_cast<clock::duration>(
+                               std::chrono::seconds(run_config.duration_in_seconds));
+  auto arrival = start;
+  for (size_t requests = 0;; ++requests) {
+    arrival += std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(interarrival_seconds(rng)));
+    if (run_config.test_mode == TestMode::KFixRepeatedTimesMode ? requests >= run_config.repeated_times
+                                                                 : arrival >= end) {
+      break;
+    }
+
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lock(m);
+      queue.push_back(arrival);
+      performance_result_.max_queued_requests = std::max(performance_result_.max_queued_requests, queue.size());
+    }
+    cv.notify_one();
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(m);
+    done = true;
+  }
+  cv.notify_all();
+
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  return Status::OK();
+}
+
+void PerformanceRunner::RunOpenLoopClient(std::deque<std::chrono::high_resolution_clock::time_point>& queue,
+                                          bool& done, OrtMutex& m, OrtCondVar& cv) {
+  for (;;) {
+    std::chrono::high_resolution_clock::time_point arrival;
+    {
+      std::unique_lock<OrtMutex> lock(m);
+      cv.wait(lock, [&queue, &done]() { return done || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+
+      arrival = queue.front();
+      queue.pop_front();
+    }
+
+    bool failed = false;
+    ORT_TRY {
+      session_->Run();
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        std::cerr << "PerformanceRunner::RunOpenLoopClient caught exception: " << ex.what() << std::endl;
+        failed = true;
+      });
+    }
+
+    const std::chrono::duration<double> latency = std::chrono::high_resolution_clock::now() - arrival;
+
+    std::lock_guard<OrtMutex> guard(results_mutex_);
+    if (failed) {
+      // a failed request has no meaningful latency and must not count towards the achieved rate
+      ++performance_result_.failed_requests;
+      continue;
+    }
+
+    performance_result_.time_costs.emplace_back(latency.count());
+    performance_result_.total_time_cost += latency.count();
+    if (performance_test_config_.run_config.f_verbose) {
+      std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+                << "latency:" << latency.count() << std::endl;
+    }
+  }
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
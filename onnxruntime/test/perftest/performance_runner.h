@@ -10,6 +10,7 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <deque>
 // onnxruntime dependencies
 #include <core/common/common.h>
 #include <core/common/status.h>
@@ -35,6 +36,10 @@ struct PerformanceResult {
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
+  // open-loop load test only: the maximum number of requests waiting for a free client.
+  size_t max_queued_requests{0};
+  // open-loop load test only: the number of requests that failed. They are not included in time_costs.
+  size_t failed_requests{0};
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
 };
@@ -88,6 +93,9 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
+  void RunOpenLoopClient(std::deque<std::chrono::high_resolution_clock::time_point>& queue, bool& done,
+                         OrtMutex& m, OrtCondVar& cv);
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -41,6 +41,8 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // when > 0, requests arrive as a Poisson process at this rate and are served by concurrent_session_runs clients
+  double target_qps{0};
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
@@ -3,11 +3,14 @@
 
 #include "core/platform/env.h"
 
+#include <cstring>
 #include <fstream>
+#include <set>
 
 #include "gtest/gtest.h"
 
 #include "core/common/path_string.h"
+#include "core/framework/allocator.h"
 #include "test/util/include/asserts.h"
 
 namespace onnxruntime {
@@ -33,5 +36,28 @@ TEST(PlatformEnvTest, DirectoryCreationAndDeletion) {
   ASSERT_FALSE(env.FolderExists(root_dir));
 }
 
+TEST(PlatformEnvTest, NumaNodeThreadAffinityMasks) {
+  const auto numa_nodes = Env::Default().GetNumaNodeThreadAffinityMasks();
+  if (numa_nodes.empty()) {
+    GTEST_SKIP() << "NUMA topology is not available";
+  }
+
+  // the nodes don't share processors
+  std::set<size_t> processors;
+  for (const auto& node : numa_nodes) {
+    for (size_t processor : node) {
+      ASSERT_TRUE(processors.insert(processor).second);
+    }
+  }
+
+  // memory preferring the first node is usable
+  NumaCPUAllocator allocator(0);
+  const size_t size = 1 << 20;
+  void* p = allocator.Alloc(size);
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, size);
+  allocator.Free(p);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -114,6 +114,43 @@ TEST(GemmOpTest, GemmNoTrans_bfloat16) {
 }
 #endif
 
+// The CPU kernels for MLFloat16 and BFloat16 keep the tensors 16-bit and accumulate in float.
+template <typename T>
+void RunCpuHalfGemmTest(bool b_is_initializer) {
+  auto to_half = [](const std::vector<float>& values) {
+    std::vector<T> result;
+    for (float v : values) {
+      result.push_back(T(v));
+    }
+    return result;
+  };
+
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+  test.AddInput<T>("A", {2, 4}, to_half({1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -2.0f, -3.0f, -4.0f}));
+  test.AddInput<T>("B", {3, 4}, to_half({1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, -1.0f, 2.0f}),
+                   b_is_initializer);
+  test.AddInput<T>("C", {3}, to_half({1.0f, 0.0f, -1.0f}));
+  test.AddOutput<T>("Y", {2, 3}, to_half({4.0f, 3.0f, 2.0f, 0.0f, -3.0f, -6.0f}));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(GemmOpTest, GemmTransB_f16_Cpu) {
+  RunCpuHalfGemmTest<MLFloat16>(false);
+  RunCpuHalfGemmTest<MLFloat16>(true);
+}
+
+TEST(GemmOpTest, GemmTransB_bfloat16_Cpu) {
+  RunCpuHalfGemmTest<BFloat16>(false);
+  RunCpuHalfGemmTest<BFloat16>(true);
+}
+
 template <typename T>
 void TestGemmBroadcast() {
   auto run_test = [](bool b_is_initializer, bool c_is_initializer) {
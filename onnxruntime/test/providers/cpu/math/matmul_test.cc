@@ -218,6 +218,40 @@ TEST(MathOpTest, MatMul_BFloat16) {
 }
 #endif
 
+// The CPU kernels for MLFloat16 and BFloat16 keep the tensors 16-bit and accumulate in float.
+template <typename T>
+void RunCpuHalfMatMulTest(bool b_is_initializer) {
+  auto to_half = [](const std::vector<float>& values) {
+    std::vector<T> result;
+    for (float v : values) {
+      result.push_back(T(v));
+    }
+    return result;
+  };
+
+  OpTester test("MatMul", 13);
+  test.AddInput<T>("A", {2, 2, 4}, to_half({1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -2.0f, -3.0f, -4.0f,
+                                            0.5f, 1.0f, 1.5f, 2.0f, 2.0f, 0.0f, -2.0f, 0.0f}));
+  test.AddInput<T>("B", {4, 3}, to_half({1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 2.0f}),
+                   b_is_initializer);
+  test.AddOutput<T>("Y", {2, 2, 3}, to_half({4.0f, 6.0f, 8.0f, -4.0f, -6.0f, -8.0f,
+                                             2.0f, 3.0f, 4.0f, 0.0f, 0.0f, 4.0f}));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, MatMul_Float16_Cpu) {
+  RunCpuHalfMatMulTest<MLFloat16>(false);
+  RunCpuHalfMatMulTest<MLFloat16>(true);
+}
+
+TEST(MathOpTest, MatMul_BFloat16_Cpu) {
+  RunCpuHalfMatMulTest<BFloat16>(false);
+  RunCpuHalfMatMulTest<BFloat16>(true);
+}
+
 #ifndef ENABLE_TRAINING  // Prepacking is enabled only on non-training builds
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   OpTester test("MatMul");
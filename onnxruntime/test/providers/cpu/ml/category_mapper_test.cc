@@ -43,5 +43,27 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+// Enough elements for the lookup to be split across threads.
+TEST(CategoryMapper, LargeInput) {
+  const std::vector<std::string> categories = {"Unknown", "One", "Two", "Three"};
+  std::vector<int64_t> dims{10, 1000};
+
+  std::vector<int64_t> int_input;
+  std::vector<std::string> string_output;
+  std::vector<std::string> string_input;
+  std::vector<int64_t> int_output;
+  for (int64_t i = 0; i < dims[0] * dims[1]; ++i) {
+    const int64_t index = i % 4;
+    int_input.push_back(index);
+    string_output.push_back(index == 0 ? "default" : categories[static_cast<size_t>(index)]);
+    string_input.push_back(categories[static_cast<size_t>(index)]);
+    int_output.push_back(index == 0 ? 99 : index);
+  }
+
+  RunTest(dims, int_input, string_output);
+  RunTest(dims, string_input, int_output);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -42,6 +42,28 @@ TEST(LabelEncoder, IntToString) {
   RunTest(dims, input, output);
 }
 
+// Enough elements for the lookup to be split across threads.
+TEST(LabelEncoder, LargeInput) {
+  const std::vector<std::string> labels = {"Beer", "Wine", "Tequila"};
+  std::vector<int64_t> dims{100, 100};
+
+  std::vector<std::string> string_data;
+  std::vector<int64_t> int_data;
+  for (int64_t i = 0; i < dims[0] * dims[1]; ++i) {
+    const int64_t index = i % 5;
+    string_data.push_back(index < 3 ? labels[static_cast<size_t>(index)] : "Burger" + std::to_string(i));
+    int_data.push_back(index < 3 ? index : 99);
+  }
+
+  RunTest(dims, string_data, int_data);
+
+  std::vector<std::string> expected_strings;
+  for (const auto& s : string_data) {
+    expected_strings.push_back(s.compare(0, 6, "Burger") == 0 ? "Water" : s);
+  }
+  RunTest(dims, int_data, expected_strings);
+}
+
 TEST(LabelEncoder, StringToIntOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
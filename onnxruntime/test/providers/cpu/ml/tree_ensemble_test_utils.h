@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "gsl/gsl"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Runs the test with the default choice of evaluation engine and with each engine forced, so that every path is
+// covered whatever the batch size of the test.
+inline void RunWithEachTreeEnsembleEngine(OpTester& test) {
+  using ml::detail::TreeEnsembleEngine;
+  auto& forced_engine = ml::detail::TreeEnsembleEngineForTesting();
+  auto reset_engine = gsl::finally([&forced_engine]() { forced_engine = TreeEnsembleEngine::kDefault; });
+  for (auto engine : {TreeEnsembleEngine::kDefault, TreeEnsembleEngine::kNodes, TreeEnsembleEngine::kFlat,
+                      TreeEnsembleEngine::kQuickScorer}) {
+    forced_engine = engine;
+    test.Run();
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
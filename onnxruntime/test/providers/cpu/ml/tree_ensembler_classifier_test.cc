@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/providers/cpu/ml/tree_ensemble_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -51,7 +52,7 @@ void TreeEnsembleClassifierTest(int opsetml) {
   test.AddInput<float>("X", {N, 3}, X);
   test.AddOutput<int64_t>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeEnsembleClassifier) {
@@ -119,7 +120,7 @@ TEST(MLOpTest, TreeEnsembleClassifier_as_tensor) {
   test.AddInput<double>("X", {N, 3}, X);
   test.AddOutput<int64_t>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeEnsembleClassifier_N1) {
@@ -164,7 +165,7 @@ TEST(MLOpTest, TreeEnsembleClassifier_N1) {
   test.AddInput<float>("X", {N, 3}, X);
   test.AddOutput<int64_t>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeEnsembleClassifierLabels) {
@@ -212,7 +213,7 @@ TEST(MLOpTest, TreeEnsembleClassifierLabels) {
   test.AddOutput<std::string>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, static_cast<int64_t>(labels.size())}, scores);
 
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeEnsembleClassifierBinary) {
@@ -261,7 +262,7 @@ TEST(MLOpTest, TreeEnsembleClassifierBinary) {
   test.AddOutput<int64_t>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, 1}, scores);
 
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeEnsembleClassifierBinaryProbabilities) {
@@ -319,7 +320,7 @@ TEST(MLOpTest, TreeEnsembleClassifierBinaryProbabilities) {
   test.AddOutput<int64_t>("Y", {N}, results);
   test.AddOutput<float>("Z", {N, 2}, scores);
 
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 }  // namespace test
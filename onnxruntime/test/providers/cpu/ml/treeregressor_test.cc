@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/providers/cpu/ml/tree_ensemble_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -121,7 +122,7 @@ void GenTreeAndRunTest(int opsetml, const std::vector<T>& X, const std::vector<f
     test.AddOutput<float>("Y", {n_obs, 2}, yn);
   }
 
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }  // namespace test
 
 template <typename T, typename TH>
@@ -238,7 +239,7 @@ void GenTreeAndRunTest_as_tensor(int opsetml, const std::vector<T>& X, const std
     test.AddOutput<float>("Y", {n_obs, 2}, yn);
   }
 
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }  // namespace test
 
 TEST(MLOpTest, TreeRegressorMultiTargetBatchTreeA2) {
@@ -428,7 +429,7 @@ void GenTreeAndRunTest1(int opsetml, const std::string& aggFunction, bool one_ob
     test.AddInput<float>("X", {n_obs, 2}, xn);
     test.AddOutput<float>("Y", {n_obs, 1}, yn);
   }
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 void GenTreeAndRunTest1_as_tensor(int opsetml, const std::string& aggFunction, bool one_obs, int64_t n_obs = 3, int n_trees = 1) {
@@ -542,7 +543,7 @@ void GenTreeAndRunTest1_as_tensor(int opsetml, const std::string& aggFunction, b
     test.AddInput<double>("X", {n_obs, 2}, xn);
     test.AddOutput<float>("Y", {n_obs, 1}, yn);
   }
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetSum) {
@@ -579,6 +580,8 @@ TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeB) {
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeC) {
   GenTreeAndRunTest1(1, "AVERAGE", false, 3, 1);  // section C
   GenTreeAndRunTest1(3, "AVERAGE", false, 3, 1);  // section C
+  GenTreeAndRunTest1(1, "AVERAGE", false, 45, 1);  // section C, several blocks of rows
+  GenTreeAndRunTest1(3, "AVERAGE", false, 45, 1);  // section C, several blocks of rows
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetBatchTreeD) {
@@ -669,12 +672,100 @@ void GenTreeAndRunTest1_as_tensor_precision(int opsetml) {
   std::vector<float> Y{11001, 101010, 10101, 11010, 11001};
   test.AddInput<double>("X", {5, 2}, X);
   test.AddOutput<float>("Y", {5, 1}, Y);
-  test.Run();
+  RunWithEachTreeEnsembleEngine(test);
 }
 
 TEST(MLOpTest, TreeRegressorSingleTargetSum_as_tensor_precision) {
   GenTreeAndRunTest1_as_tensor_precision(3);
 }
 
+void GenTreeAndRunTestMissingTracks(const std::string& second_tree_mode, const std::vector<float>& expected) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  // tree 0 sends missing values to the true branch, tree 1 does not, tree 2 is a single leaf.
+  std::vector<int64_t> lefts = {1, 0, 0, 1, 0, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0, 2, 0, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2, 0};
+  std::vector<int64_t> featureids = {0, 0, 0, 1, 0, 0, 0};
+  std::vector<float> thresholds = {1, 0, 0, 0, 0, 0, 0};
+  std::vector<int64_t> missing_tracks_true = {1, 0, 0, 0, 0, 0, 0};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF", second_tree_mode, "LEAF", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1, 2};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2, 0};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0, 0};
+  std::vector<float> target_weights = {1, 10, 100, 1000, 10000};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0, 0, 2, 1, nan, nan};
+  test.AddInput<float>("X", {3, 2}, X);
+  test.AddOutput<float>("Y", {3, 1}, expected);
+  RunWithEachTreeEnsembleEngine(test);
+}
+
+TEST(MLOpTest, TreeRegressorMissingTracksSameMode) {
+  // all the branches share the same mode so the flattened layout is used
+  GenTreeAndRunTestMissingTracks("BRANCH_LEQ", {10101, 11010, 11001});
+}
+
+TEST(MLOpTest, TreeRegressorMissingTracksMixedModes) {
+  GenTreeAndRunTestMissingTracks("BRANCH_GT", {11001, 10110, 11001});
+}
+
+TEST(MLOpTest, TreeRegressorBranchLeqAndLt) {
+  // only BRANCH_LEQ and BRANCH_LT nodes without missing tracks so the quick scorer is used.
+  // trees 0 and 1 test the same value on feature 0 with a different mode.
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, 0, 0, 1, 0, 0, 1, 3, 5, 0, 0, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0, 2, 0, 0, 2, 4, 6, 0, 0, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2, 0, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> featureids = {0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0};
+  std::vector<float> thresholds = {1, 0, 0, 1, 0, 0, 0.5f, 0, 5, 0, 0, 0, 0};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LT", "LEAF", "LEAF", "BRANCH_LEQ",
+                                    "BRANCH_LEQ", "BRANCH_LT", "LEAF", "LEAF", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1, 2, 2, 2, 2};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0, 0, 0, 0, 0};
+  std::vector<float> target_weights = {1, 10, 100, 1000, 10000, 20000, 40000, 80000};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0, 0, 1, 1, 2, 7, nan, nan};
+  std::vector<float> Y = {10101, 41001, 81010, 81010};
+  test.AddInput<float>("X", {4, 2}, X);
+  test.AddOutput<float>("Y", {4, 1}, Y);
+  RunWithEachTreeEnsembleEngine(test);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
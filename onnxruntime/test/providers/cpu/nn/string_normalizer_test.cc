@@ -202,6 +202,38 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+TEST(ContribOpTest, StringNormalizerLargeInput) {
+  // - case-INSENSETIVE approach
+  // - enough strings for the work to be split across threads
+  // - filter out monday in any case
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "LOWER", false, {u8"MONDAY"}, test_locale);
+  const std::vector<std::string> words = {std::string(u8"Monday"), std::string(u8"Besançon"),
+                                          std::string(u8"ПОНЕДЕЛЬНИК"), std::string(u8"monday"),
+                                          std::string(u8"中文")};
+  const std::vector<std::string> lowered = {std::string(u8"besançon"), std::string(u8"понедельник"),
+                                            std::string(u8"中文")};
+  constexpr int64_t repeats = 2000;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < repeats; ++i) {
+    input.insert(input.end(), words.cbegin(), words.cend());
+    output.insert(output.end(), lowered.cbegin(), lowered.cend());
+  }
+  test.AddInput<std::string>("T", {1, static_cast<int64_t>(input.size())}, input);
+  test.AddOutput<std::string>("Y", {1, static_cast<int64_t>(output.size())}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, StringNormalizerInvalidUtf8) {
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "UPPER", true, {}, test_locale);
+  std::vector<std::string> input = {std::string("monday"), std::string("\xC3\x28")};
+  test.AddInput<std::string>("T", {2}, input);
+  test.AddOutput<std::string>("Y", {2}, input);
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Input contains invalid utf8 chars");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
 #endif
\ No newline at end of file
@@ -383,5 +383,50 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManyBoxesTwoBatchesThreeClasses) {
+  // 4 groups of 100 identical boxes. In each batch and class, the boxes of a group are suppressed by the box of the
+  // group with the highest score, and the groups are ranked differently, so most candidates are visited and
+  // suppressed before the 3 boxes are selected.
+  constexpr int64_t num_batches = 2;
+  constexpr int64_t num_classes = 3;
+  constexpr int64_t num_groups = 4;
+  constexpr int64_t group_size = 100;
+  constexpr int64_t num_boxes = num_groups * group_size;
+  constexpr int64_t max_output_boxes_per_class = 3;
+
+  std::vector<float> boxes;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t i = 0; i < num_boxes; ++i) {
+      const float x = 10.0f * static_cast<float>(i / group_size);
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+  }
+
+  std::vector<float> scores;
+  std::vector<int64_t> expected;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t c = 0; c < num_classes; ++c) {
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        const int64_t rank = (i / group_size + b + c) % num_groups;
+        scores.push_back(static_cast<float>(num_groups - rank) + 0.001f * static_cast<float>((i * 37) % group_size));
+      }
+      // The box with (i * 37) % 100 == 99 has the highest score of its group.
+      for (int64_t rank = 0; rank < max_output_boxes_per_class; ++rank) {
+        const int64_t group = ((rank - b - c) % num_groups + num_groups) % num_groups;
+        expected.insert(expected.end(), {b, c, group * group_size + 27});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output_boxes_per_class});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * max_output_boxes_per_class, 3}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -130,6 +130,31 @@ TEST(CastOpTest, NonStringTypes) {
       CastNonStringTester{});
 }
 
+// large enough to be split across threads and to cover the vectorized float16 conversions and their remainders
+TEST(CastOpTest, LargeTensorFloat16Types) {
+  const std::vector<int64_t> shape{3, 1027, 33};
+  const size_t size = gsl::narrow<size_t>(TensorShape(shape).Size());
+
+  // values that are exactly representable in every type below
+  std::vector<float> float_values(size);
+  for (size_t i = 0; i < size; ++i) {
+    float_values[i] = static_cast<float>(static_cast<int>(i % 256) - 128) / 4.0f;
+  }
+  const auto float_span = gsl::make_span(float_values);
+
+  const std::vector<MLFloat16> float16_values = CastedValues<float, MLFloat16>(float_span);
+  const std::vector<BFloat16> bfloat16_values = CastedValues<float, BFloat16>(float_span);
+  const std::vector<int32_t> int32_values = CastedValues<float, int32_t>(float_span);
+
+  TestCastOp(float_span, gsl::make_span(float16_values), shape);
+  TestCastOp(gsl::make_span(float16_values), float_span, shape);
+  TestCastOp(float_span, gsl::make_span(bfloat16_values), shape);
+  TestCastOp(gsl::make_span(bfloat16_values), float_span, shape);
+  TestCastOp(gsl::make_span(float16_values), gsl::make_span(bfloat16_values), shape);
+  TestCastOp(gsl::make_span(float16_values), gsl::make_span(int32_values), shape);
+  TestCastOp(gsl::make_span(int32_values), gsl::make_span(float16_values), shape);
+}
+
 TEST(CastOpTest, FromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   const std::vector<std::string> string_data = {"-inf", "+INF", "0.9767611", "0.28280696",
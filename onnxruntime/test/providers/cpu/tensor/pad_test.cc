@@ -804,6 +804,45 @@ TYPED_TEST(PadOpTest, Pad_Reflect_DimWithZeroInput) {
                                   "Cannot use 'reflect' mode to pad dimension with a value of 0. Input shape:{0,2,1}", {kTensorrtExecutionProvider});
 }
 
+// Leading axes without padding are processed in parallel ranges, so use enough of them to be split across threads.
+TYPED_TEST(PadOpTest, Pad_4D_Unpadded_Outer_Axes) {
+  using T = TypeParam;
+  const std::vector<int64_t> input_dims{2, 128, 3, 4};
+  const std::vector<int64_t> pads{0, 0, 1, 2, 0, 0, 1, 1};
+  const std::vector<int64_t> output_dims{2, 128, 5, 7};
+
+  std::vector<T> input(2 * 128 * 3 * 4);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = T(i % 100);
+  }
+
+  for (const std::string mode : {"constant", "edge", "reflect"}) {
+    std::vector<T> output;
+    for (int64_t n = 0; n < 2 * 128; ++n) {
+      for (int64_t h = -pads[2]; h < input_dims[2] + pads[6]; ++h) {
+        for (int64_t w = -pads[3]; w < input_dims[3] + pads[7]; ++w) {
+          int64_t ih = h;
+          int64_t iw = w;
+          if (mode == "edge") {
+            ih = std::clamp<int64_t>(h, 0, input_dims[2] - 1);
+            iw = std::clamp<int64_t>(w, 0, input_dims[3] - 1);
+          } else if (mode == "reflect") {
+            ih = h < 0 ? -h : (h >= input_dims[2] ? 2 * (input_dims[2] - 1) - h : h);
+            iw = w < 0 ? -w : (w >= input_dims[3] ? 2 * (input_dims[3] - 1) - w : w);
+          }
+          if (ih < 0 || ih >= input_dims[2] || iw < 0 || iw >= input_dims[3]) {
+            output.push_back(T(7));
+          } else {
+            output.push_back(input[static_cast<size_t>((n * input_dims[2] + ih) * input_dims[3] + iw)]);
+          }
+        }
+      }
+    }
+
+    RunAllOpsetAllDomainPadTests<T>(input_dims, input, pads, T(7), output_dims, output, mode);
+  }
+}
+
 TEST(PadOpTest, BoolType) {
   OpTester test("Pad", 13);
   test.AddAttribute("mode", "constant");
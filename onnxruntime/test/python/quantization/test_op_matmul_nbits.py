@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+# coding: utf-8
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import unittest
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper
+from op_test_utils import check_op_type_count
+
+import onnxruntime
+from onnxruntime.quantization.matmul_nbits_quantizer import MatMulNBitsQuantizer, quantize_blockwise
+
+
+def dequantize_blockwise(packed, scales, zero_points, k, n, bits, block_size):
+    n_blocks = (k + block_size - 1) // block_size
+    if bits == 4:
+        q = np.stack([packed & 0x0F, packed >> 4], axis=-1).reshape(n, n_blocks, block_size)
+    else:
+        q = packed.reshape(n, n_blocks, block_size)
+    if zero_points is None:
+        zp = np.full((n, n_blocks), 1 << (bits - 1), dtype=np.float32)
+    elif bits == 4:
+        zp = np.stack([zero_points & 0x0F, zero_points >> 4], axis=-1).reshape(n, -1)[:, :n_blocks]
+    else:
+        zp = zero_points.reshape(n, n_blocks)
+    deq = (q.astype(np.float32) - zp[..., np.newaxis].astype(np.float32)) * scales.reshape(n, n_blocks, 1)
+    return deq.reshape(n, -1)[:, :k].T
+
+
+class TestOpMatMulNBits(unittest.TestCase):
+    def construct_model_matmul(self, k, n):
+        #      (input)
+        #         |
+        #       MatMul
+        #         |
+        #      (output)
+        weight = np.random.uniform(-1, 1, (k, n)).astype(np.float32)
+        initializers = [onnx.numpy_helper.from_array(weight, name="weight")]
+        matmul_node = helper.make_node("MatMul", ["input", "weight"], ["output"], name="MatMul")
+        graph = helper.make_graph(
+            [matmul_node],
+            "matmul_nbits_test",
+            [helper.make_tensor_value_info("input", TensorProto.FLOAT, [-1, k])],
+            [helper.make_tensor_value_info("output", TensorProto.FLOAT, [-1, n])],
+            initializer=initializers,
+        )
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+        return model, weight
+
+    def quant_test(self, k, n, bits, block_size, is_symmetric):
+        model, weight = self.construct_model_matmul(k, n)
+        model_path = "matmul_nbits_{}_{}_{}.onnx".format(bits, block_size, int(is_symmetric))
+
+        quantizer = MatMulNBitsQuantizer(model, block_size, bits, is_symmetric)
+        quantizer.process()
+        quantizer.model.save_model_to_file(model_path)
+        check_op_type_count(self, model_path, MatMul=0, MatMulNBits=1)
+
+        packed, scales, zero_points = quantize_blockwise(weight, bits, block_size, is_symmetric)
+        dequantized = dequantize_blockwise(packed, scales, zero_points, k, n, bits, block_size)
+        # the error is at most one quantization step
+        step = np.repeat(np.abs(scales).reshape(n, -1), block_size, axis=1)[:, :k].T
+        self.assertTrue(np.all(np.abs(dequantized - weight) <= step * 1.0001))
+
+        data = np.random.uniform(-1, 1, (5, k)).astype(np.float32)
+        sess = onnxruntime.InferenceSession(model_path, providers=["CPUExecutionProvider"])
+        result = sess.run(None, {"input": data})[0]
+        np.testing.assert_allclose(result, data @ dequantized, rtol=1e-4, atol=1e-4)
+
+    def test_quantize_matmul_4bits(self):
+        np.random.seed(13)
+        for block_size in [16, 32, 128]:
+            self.quant_test(100, 64, 4, block_size, False)
+            self.quant_test(100, 64, 4, block_size, True)
+
+    def test_quantize_matmul_8bits(self):
+        np.random.seed(13)
+        for block_size in [32, 256]:
+            self.quant_test(300, 17, 8, block_size, False)
+            self.quant_test(300, 17, 8, block_size, True)
+
+
+if __name__ == "__main__":
+    unittest.main()
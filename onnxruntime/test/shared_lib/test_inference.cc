@@ -8,6 +8,7 @@
 #include <sstream>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <algorithm>
 #include <thread>
 
@@ -1041,6 +1042,89 @@ TEST(CApiTest, io_binding) {
   binding.ClearBoundOutputs();
 }
 
+namespace {
+struct RunAsyncState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t num_completed = 0;
+  size_t num_failed = 0;
+};
+
+void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+  auto* state = reinterpret_cast<RunAsyncState*>(user_data);
+  bool failed = status != nullptr || num_outputs != 1 || outputs[0] == nullptr;
+  if (status != nullptr) {
+    Ort::GetApi().ReleaseStatus(status);
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  ++state->num_completed;
+  if (failed) {
+    ++state->num_failed;
+  }
+  state->cv.notify_all();
+}
+}  // namespace
+
+TEST(CApiTest, run_async) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(), x_shape.data(), x_shape.size());
+  const std::array<float, 3 * 2> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  constexpr size_t num_runs = 8;
+  std::vector<Ort::Value> outputs;
+  for (size_t i = 0; i < num_runs; ++i) {
+    outputs.emplace_back(nullptr);
+  }
+
+  RunAsyncState state;
+  for (size_t i = 0; i < num_runs; ++i) {
+    session.RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, &outputs[i], 1, RunAsyncCallback, &state);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&state]() { return state.num_completed == num_runs; });
+  }
+
+  ASSERT_EQ(state.num_failed, 0U);
+  for (const auto& y : outputs) {
+    ASSERT_TRUE(y.IsTensor());
+    auto count = y.GetTensorTypeAndShapeInfo().GetElementCount();
+    ASSERT_EQ(expected_y.size(), count);
+    const float* values = y.GetTensorData<float>();
+    ASSERT_TRUE(std::equal(values, values + count, std::begin(expected_y)));
+  }
+}
+
+TEST(CApiTest, run_async_requires_worker_threads) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(), x_shape.data(), x_shape.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::Value y{nullptr};
+  RunAsyncState state;
+  ASSERT_THROW(session.RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, &y, 1, RunAsyncCallback, &state),
+               Ort::Exception);
+}
+
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
 TEST(CApiTest, io_binding_cuda) {
   struct CudaMemoryDeleter {